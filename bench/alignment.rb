@@ -0,0 +1,52 @@
+# frozen_string_literal: true
+
+# Measures the throughput of the fixed-size operations affected by the
+# storage alignment
+#
+# The alignment is chosen at build time, so run the benchmark once per mode
+# and compare the two outputs:
+#
+#   rake compile && ruby -Ilib bench/alignment.rb
+#   rake compile -- --enable-aligned && ruby -Ilib bench/alignment.rb
+
+require "eigen"
+
+# Returns the number of calls to the block per second
+def measure(min_duration: 1)
+    count = 0
+    start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    loop do
+        100.times { yield }
+        count += 100
+        elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+        return count / elapsed if elapsed >= min_duration
+    end
+end
+
+m1 = Eigen::Matrix4.new
+m1.from_a(Array.new(16) { rand })
+m2 = Eigen::Matrix4.new
+m2.from_a(Array.new(16) { rand })
+
+q1 = Eigen::Quaternion.from_angle_axis(0.3, Eigen::Vector3.UnitZ)
+q2 = Eigen::Quaternion.from_angle_axis(-1.2, Eigen::Vector3.UnitX)
+
+t1 = Eigen::Isometry3.new
+t1.translate(Eigen::Vector3.new(1, 2, 3))
+t1.rotate(q1)
+t2 = Eigen::Isometry3.new
+t2.translate(Eigen::Vector3.new(-1, 0, 2))
+t2.rotate(q2)
+
+benchmarks = {
+    "Matrix4#dotM" => -> { m1.dotM(m2) },
+    "Quaternion#concatenate" => -> { q1.concatenate(q2) },
+    "Isometry3#concatenate" => -> { t1.concatenate(t2) }
+}
+
+puts "Storage: #{Eigen.aligned? ? 'aligned' : 'unaligned (DontAlign)'}"
+puts format("%-24<name>s %14<ops>s", name: "operation", ops: "calls/s")
+benchmarks.each do |name, op|
+    op.call # warm up
+    puts format("%-24<name>s %14.0<ops>f", name: name, ops: measure { op.call })
+end
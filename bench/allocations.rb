@@ -0,0 +1,78 @@
+# frozen_string_literal: true
+
+# Measures the native heap cost of the objects returned by the bindings
+#
+# Every result of e.g. Vector3#+ is a new Ruby object wrapping a C++ object.
+# This script creates a batch of such results, keeps them alive and reports
+# how many bytes of native heap each one retains, as measured by glibc's
+# mallinfo2(). Each malloc'ed block costs at least 32 bytes on 64-bit glibc,
+# so the number of heap allocations per result shows up directly in the
+# figures (e.g. ~32 bytes for a Vector3 stored inline, ~64 bytes when the
+# wrapper and its Eigen payload are allocated separately).
+#
+# Run with
+#
+#   ruby -Ilib bench/allocations.rb [COUNT]
+
+require "fiddle"
+require "eigen"
+
+# Access to the native heap statistics
+module NativeHeap
+    # struct mallinfo2 is 10 size_t, uordblks (bytes in use) is the 8th
+    MALLINFO2_SIZE = 10 * Fiddle::SIZEOF_SIZE_T
+    UORDBLKS_OFFSET = 7 * Fiddle::SIZEOF_SIZE_T
+
+    # mallinfo2 returns its struct by value, which Fiddle can't express. On
+    # x86_64 and aarch64, a struct that large is returned through a
+    # caller-provided buffer whose address is passed as a hidden first
+    # argument.
+    MALLINFO2 = Fiddle::Function.new(
+        Fiddle.dlopen(nil)["mallinfo2"], [Fiddle::Types::VOIDP], Fiddle::Types::VOIDP
+    )
+
+    # Bytes currently allocated with malloc
+    def self.in_use
+        buffer = Fiddle::Pointer.malloc(MALLINFO2_SIZE, Fiddle::RUBY_FREE)
+        MALLINFO2.call(buffer)
+        buffer[UORDBLKS_OFFSET, Fiddle::SIZEOF_SIZE_T].unpack1("J")
+    end
+end
+
+def measure(name, count)
+    GC.start
+    GC.disable
+    before_heap = NativeHeap.in_use
+    before_objects = GC.stat(:total_allocated_objects)
+    results = Array.new(count) { yield }
+    after_objects = GC.stat(:total_allocated_objects)
+    after_heap = NativeHeap.in_use
+    GC.enable
+
+    native = (after_heap - before_heap).fdiv(results.size)
+    objects = (after_objects - before_objects).fdiv(results.size)
+    format("%-28<name>s %8.1<native>f native bytes/op %6.2<objects>f ruby objects/op",
+           name: name, native: native, objects: objects)
+end
+
+count = Integer(ARGV.first || 100_000)
+
+v = Eigen::Vector3.new(1, 2, 3)
+q = Eigen::Quaternion.from_angle_axis(0.5, Eigen::Vector3.UnitZ)
+aa = Eigen::AngleAxis.new(0.5, Eigen::Vector3.UnitZ)
+m4 = Eigen::Matrix4.new
+iso = Eigen::Isometry3.from_position_orientation(v, q)
+aff = Eigen::Affine3.from_position_orientation(v, q)
+vx = Eigen::VectorX.from_a([1, 2, 3])
+mx = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+
+puts measure("Vector3#+", count) { v + v }
+puts measure("Quaternion#concatenate", count) { q.concatenate(q) }
+puts measure("Quaternion#transform", count) { q.transform(v) }
+puts measure("AngleAxis#inverse", count) { aa.inverse }
+puts measure("Matrix4#dotM", count) { m4.dotM(m4) }
+puts measure("Isometry3#concatenate", count) { iso.concatenate(iso) }
+puts measure("Isometry3#transform", count) { iso.transform(v) }
+puts measure("Affine3#concatenate", count) { aff.concatenate(aff) }
+puts measure("VectorX#+", count) { vx + vx }
+puts measure("MatrixX#+", count) { mx + mx }
@@ -0,0 +1,275 @@
+# frozen_string_literal: true
+
+# Benchmark suite covering the bound classes
+#
+# For each operation, it reports the number of calls per second, the number
+# of Ruby objects allocated per call and the growth of the process' resident
+# set size while the operation ran. The results are also saved as JSON so
+# that runs can be compared over time.
+#
+# Run with
+#
+#   rake bench
+#
+# or directly
+#
+#   ruby -Ilib bench/suite.rb [--filter REGEXP] [--duration SECONDS]
+#        [--output PATH] [--compare PATH]
+#
+# By default the results are saved in bench/results/. --compare prints the
+# speed ratio against a previously saved run.
+
+require "fileutils"
+require "json"
+require "optparse"
+require "time"
+require "eigen"
+
+# Minimal benchmark harness
+class Suite
+    Result = Struct.new(:name, :ops_per_sec, :allocations_per_op, :rss_growth_kb) do
+        def to_h
+            { "name" => name, "ops_per_sec" => ops_per_sec,
+              "allocations_per_op" => allocations_per_op,
+              "rss_growth_kb" => rss_growth_kb }
+        end
+    end
+
+    attr_reader :results
+
+    def initialize(filter: nil, duration: 0.5)
+        @filter = filter
+        @duration = duration
+        @results = []
+    end
+
+    # Resident set size of the process in kB, or nil if it cannot be read
+    def self.rss_kb
+        status = File.read("/proc/self/status")
+        status[/^VmRSS:\s+(\d+)/, 1]&.to_i
+    rescue SystemCallError
+        nil
+    end
+
+    # Measures a block and prints and records the result
+    def bench(name, &block)
+        return if @filter && name !~ @filter
+
+        block.call # warm up
+        allocations = allocations_per_call(&block)
+
+        GC.start
+        rss_before = Suite.rss_kb
+        ops = calls_per_second(&block)
+        rss_after = Suite.rss_kb
+        rss_growth = rss_after - rss_before if rss_before && rss_after
+
+        result = Result.new(name, ops, allocations, rss_growth)
+        @results << result
+        puts Suite.format_result(result)
+    end
+
+    def self.format_header
+        format("%-40<name>s %14<ops>s %12<allocs>s %12<rss>s",
+               name: "operation", ops: "calls/s", allocs: "objects/call",
+               rss: "RSS growth")
+    end
+
+    def self.format_result(result)
+        rss = result.rss_growth_kb ? "#{result.rss_growth_kb} kB" : "n/a"
+        format("%-40<name>s %14.1<ops>f %12.2<allocs>f %12<rss>s",
+               name: result.name, ops: result.ops_per_sec,
+               allocs: result.allocations_per_op, rss: rss)
+    end
+
+    private
+
+    def allocations_per_call(count: 100)
+        before = GC.stat(:total_allocated_objects)
+        count.times { yield }
+        (GC.stat(:total_allocated_objects) - before).fdiv(count)
+    end
+
+    def calls_per_second
+        count = 0
+        batch = 1
+        start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+        loop do
+            batch.times { yield }
+            count += batch
+            elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+            return count / elapsed if elapsed >= @duration
+
+            batch *= 2 if batch < 1024
+        end
+    end
+end
+
+def random_matrix(klass, rows, cols)
+    klass.from_a(Array.new(rows * cols) { rand }, rows, cols)
+end
+
+def random_vectors(size)
+    Eigen::Vector3Array.from_vectors(
+        Array.new(size) { Eigen::Vector3.new(rand, rand, rand) }
+    )
+end
+
+options = {
+    duration: 0.5,
+    output: File.join(__dir__, "results",
+                      "#{Time.now.utc.strftime('%Y%m%dT%H%M%S')}.json")
+}
+OptionParser.new do |opt|
+    opt.on("--filter REGEXP", "only run the operations matching REGEXP") do |f|
+        options[:filter] = Regexp.new(f)
+    end
+    opt.on("--duration SECONDS", Float, "minimum duration of each measurement") do |d|
+        options[:duration] = d
+    end
+    opt.on("--output PATH", "where to save the results") { |p| options[:output] = p }
+    opt.on("--compare PATH", "previous results to compare against") do |p|
+        options[:compare] = p
+    end
+end.parse!(ARGV)
+
+suite = Suite.new(filter: options[:filter], duration: options[:duration])
+puts Suite.format_header
+
+# Fixed-size types
+v = Eigen::Vector3.new(1, 2, 3)
+vf = Eigen::Vector3f.new(1, 2, 3)
+q = Eigen::Quaternion.from_angle_axis(0.5, Eigen::Vector3.UnitZ)
+qf = q.to_single
+aa = Eigen::AngleAxis.new(0.5, Eigen::Vector3.UnitZ)
+m4 = Eigen::Matrix4.new
+m4.from_a(Array.new(16) { rand })
+iso = Eigen::Isometry3.from_position_orientation(v, q)
+aff = Eigen::Affine3.from_position_orientation(v, q)
+
+suite.bench("Vector3.new") { Eigen::Vector3.new(1, 2, 3) }
+suite.bench("Vector3#+") { v + v }
+suite.bench("Vector3#cross") { v.cross(v) }
+suite.bench("Vector3f#+") { vf + vf }
+suite.bench("Vector3 Marshal round-trip") { Marshal.load(Marshal.dump(v)) }
+suite.bench("Quaternion.from_angle_axis") do
+    Eigen::Quaternion.from_angle_axis(0.5, Eigen::Vector3.UnitZ)
+end
+suite.bench("Quaternion#concatenate") { q.concatenate(q) }
+suite.bench("Quaternion#transform") { q.transform(v) }
+suite.bench("Quaternionf#concatenate") { qf.concatenate(qf) }
+suite.bench("Quaternion Marshal round-trip") { Marshal.load(Marshal.dump(q)) }
+suite.bench("AngleAxis.new") { Eigen::AngleAxis.new(0.5, v) }
+suite.bench("AngleAxis#inverse") { aa.inverse }
+suite.bench("Matrix4.new") { Eigen::Matrix4.new }
+suite.bench("Matrix4#+") { m4 + m4 }
+suite.bench("Matrix4#dotM") { m4.dotM(m4) }
+suite.bench("Isometry3.new") { Eigen::Isometry3.new }
+suite.bench("Isometry3#concatenate") { iso.concatenate(iso) }
+suite.bench("Isometry3#transform") { iso.transform(v) }
+suite.bench("Affine3#concatenate") { aff.concatenate(aff) }
+suite.bench("Affine3#transform") { aff.transform(v) }
+
+# Batches
+[100, 10_000].each do |size|
+    points = random_vectors(size)
+    out = Eigen::Vector3Array.new(size)
+    suite.bench("Vector3Array#+ (#{size})") { points + v }
+    suite.bench("Isometry3#transform_all (#{size})") { iso.transform_all(points) }
+    suite.bench("Isometry3#transform_all! (#{size})") { iso.transform_all!(out) }
+end
+
+neighbourhood = random_vectors(16)
+suite.bench("Vector3Array#principal_components (16)") { neighbourhood.principal_components }
+
+# Dynamic-size types
+[8, 64, 256].each do |size|
+    values = Array.new(size * size) { rand }
+    m = random_matrix(Eigen::MatrixX, size, size)
+    mf = m.to_single
+    vx = Eigen::VectorX.from_a(Array.new(size) { rand })
+
+    suite.bench("MatrixX.new (#{size}x#{size})") { Eigen::MatrixX.new(size, size) }
+    suite.bench("MatrixX.Zero (#{size}x#{size})") { Eigen::MatrixX.Zero(size, size) }
+    suite.bench("MatrixX.hstack (#{size}x#{size} x 4)") { Eigen::MatrixX.hstack([m, m, m, m]) }
+    suite.bench("MatrixX.from_a (#{size}x#{size})") do
+        Eigen::MatrixX.from_a(values, size, size)
+    end
+    suite.bench("MatrixX#to_a (#{size}x#{size})") { m.to_a }
+    suite.bench("MatrixX Marshal round-trip (#{size}x#{size})") do
+        Marshal.load(Marshal.dump(m))
+    end
+    suite.bench("MatrixX#+ (#{size}x#{size})") { m + m }
+    suite.bench("MatrixX#* (#{size}x#{size})") { m * 2 }
+    suite.bench("MatrixX lazy a*2+b-c (#{size}x#{size})") { (m.lazy * 2 + m - m).eval }
+    suite.bench("MatrixX#dotV (#{size}x#{size})") { m.dotV(vx) }
+    suite.bench("MatrixX#dotM (#{size}x#{size})") { m.dotM(m) }
+    suite.bench("MatrixXf#dotM (#{size}x#{size})") { mf.dotM(mf) }
+    suite.bench("MatrixX#jacobiSvd (#{size}x#{size})") { m.jacobiSvd }
+    suite.bench("MatrixX#lu (#{size}x#{size})") { m.lu }
+    suite.bench("MatrixX#sum (#{size}x#{size})") { m.sum }
+    suite.bench("MatrixX#colwise_sum (#{size}x#{size})") { m.colwise_sum }
+    suite.bench("MatrixX#covariance (#{size}x#{size})") { m.covariance }
+
+    suite.bench("VectorX.from_a (#{size})") { Eigen::VectorX.from_a(values.first(size)) }
+    suite.bench("VectorX#+ (#{size})") { vx + vx }
+    suite.bench("VectorX#dot (#{size})") { vx.dot(vx) }
+    suite.bench("VectorX#cwise_exp (#{size})") { vx.cwise_exp }
+    suite.bench("VectorX#cwise_clamp! (#{size})") { vx.cwise_clamp!(0, 1) }
+end
+
+# Sparse matrices
+[1_000, 100_000].each do |size|
+    rows = (0...size).to_a + (1...size).to_a + (0...size - 1).to_a
+    cols = (0...size).to_a + (0...size - 1).to_a + (1...size).to_a
+    values = Array.new(size, 2.0) + Array.new(2 * (size - 1), -1.0)
+    packed = [rows.pack("l*"), cols.pack("l*"), values.pack("d*")]
+    sparse = Eigen::SparseMatrix.from_triplets(size, size, *packed)
+    rhs = Eigen::VectorX.from_a(Array.new(size) { rand })
+    ldlt = Eigen::SimplicialLDLT.new
+    ldlt.compute(sparse)
+
+    suite.bench("SparseMatrix.from_triplets packed (#{size})") do
+        Eigen::SparseMatrix.from_triplets(size, size, *packed)
+    end
+    suite.bench("SparseMatrix#dotV (#{size})") { sparse.dotV(rhs) }
+    suite.bench("SimplicialLDLT#factorize (#{size})") { ldlt.factorize(sparse) }
+    suite.bench("SimplicialLDLT#solve (#{size})") { ldlt.solve(rhs) }
+end
+
+# Instrumentation, disabling it must bring back the uninstrumented speed
+Eigen.stats_enabled = true
+suite.bench("Vector3#+ (stats enabled)") { v + v }
+Eigen.stats_enabled = false
+suite.bench("Vector3#+ (stats disabled)") { v + v }
+
+if options[:output]
+    FileUtils.mkdir_p(File.dirname(options[:output]))
+    report = {
+        "time" => Time.now.utc.iso8601,
+        "ruby" => RUBY_DESCRIPTION,
+        "version" => Eigen::VERSION,
+        "aligned" => Eigen.aligned?,
+        "openmp" => Eigen.openmp?,
+        "threads" => Eigen.threads,
+        "results" => suite.results.map(&:to_h)
+    }
+    File.write(options[:output], JSON.pretty_generate(report))
+    puts "results saved in #{options[:output]}"
+end
+
+if options[:compare]
+    previous = JSON.parse(File.read(options[:compare]))["results"]
+                   .to_h { |r| [r["name"], r] }
+    puts
+    puts format("%-40<name>s %14<before>s %14<after>s %8<ratio>s",
+                name: "operation", before: "before", after: "after", ratio: "speedup")
+    suite.results.each do |result|
+        next unless (before = previous[result.name])
+
+        puts format("%-40<name>s %14.1<before>f %14.1<after>f %7.2<ratio>fx",
+                    name: result.name, before: before["ops_per_sec"],
+                    after: result.ops_per_sec,
+                    ratio: result.ops_per_sec / before["ops_per_sec"])
+    end
+end
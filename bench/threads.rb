@@ -0,0 +1,54 @@
+# frozen_string_literal: true
+
+# Measures how MatrixX#dotM throughput scales with Eigen.threads
+#
+# Eigen only parallelizes its products if the extension has been built with
+# OpenMP:
+#
+#   rake compile -- --enable-openmp
+#   ruby -Ilib bench/threads.rb [SIZE...]
+
+require "etc"
+require "eigen"
+
+def random_matrix(size)
+    m = Eigen::MatrixX.new
+    m.from_a(Array.new(size * size) { rand }, size, size)
+    m
+end
+
+# Returns the number of products per second
+def measure(a, b, min_duration: 1)
+    count = 0
+    start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+    loop do
+        a.dotM(b)
+        count += 1
+        elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+        return count / elapsed if elapsed >= min_duration
+    end
+end
+
+sizes = ARGV.empty? ? [256, 512, 1024] : ARGV.map { |s| Integer(s) }
+thread_counts = [1, 2, 4, 8, 16, 32].select { |n| n <= Etc.nprocessors }
+initial_threads = Eigen.threads
+
+puts "OpenMP: #{Eigen.openmp? ? 'enabled' : 'disabled, products are single-threaded'}"
+puts format("%-6<size>s %-8<threads>s %12<ops>s %10<gflops>s %8<speedup>s",
+            size: "size", threads: "threads", ops: "products/s",
+            gflops: "GFLOP/s", speedup: "speedup")
+sizes.each do |size|
+    a = random_matrix(size)
+    b = random_matrix(size)
+    baseline = nil
+    thread_counts.each do |n|
+        Eigen.threads = n
+        a.dotM(b) # warm up
+        ops = measure(a, b)
+        baseline ||= ops
+        puts format("%-6<size>d %-8<threads>d %12.2<ops>f %10.2<gflops>f %7.2<speedup>fx",
+                    size: size, threads: n, ops: ops,
+                    gflops: ops * 2 * size**3 / 1e9, speedup: ops / baseline)
+    end
+end
+Eigen.threads = initial_threads
@@ -1,25 +1,876 @@
 #include "rice/Class.hpp"
 #include "rice/String.hpp"
+#include "rice/Array.hpp"
 #include "rice/Constructor.hpp"
 #include "rice/Enum.hpp"
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <Eigen/SVD>
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <Eigen/QR>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Sparse>
+
+#include <ruby/thread.h>
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+#include <ruby/memory_view.h>
+#endif
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdint.h>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using namespace Rice;
 
-typedef Eigen::Matrix<double, 3, 1, Eigen::DontAlign>     Vector3d;
-typedef Eigen::Matrix<double, 4, 4, Eigen::DontAlign>     Matrix4d;
-typedef Eigen::Quaternion<double, Eigen::DontAlign>    Quaterniond;
-typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign>
-                                                       MatrixXd;
-typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::DontAlign>
-                                                       VectorXd;
+/* Storage option of the fixed-size types
+ *
+ * They are DontAlign by default. Building with --enable-aligned defines
+ * EIGEN_RUBY_ALIGNED, which keeps Eigen's default alignment so that it can
+ * use aligned SIMD loads and stores for Matrix4 and Quaternion. The
+ * coefficients are laid out the same way in both modes, only the alignment
+ * of their address changes, so conversions (to_a, to_binary, ...) are
+ * unaffected.
+ */
+#ifdef EIGEN_RUBY_ALIGNED
+static const int FixedStorage = Eigen::AutoAlign;
+#else
+static const int FixedStorage = Eigen::DontAlign;
+#endif
+
+/* Vector3, VectorX, MatrixX and Quaternion exist in double and single
+ * precision, so their storage is parametrized by the scalar type */
+template<typename Scalar>
+using EigenVector3 = Eigen::Matrix<Scalar, 3, 1, FixedStorage>;
+template<typename Scalar>
+using EigenQuaternion = Eigen::Quaternion<Scalar, FixedStorage>;
+template<typename Scalar>
+using EigenMatrixX = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign>;
+template<typename Scalar>
+using EigenVectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1, Eigen::DontAlign>;
+
+/* The scalar type of the other precision, used by the conversions between
+ * the double and single precision types */
+template<typename Scalar> struct OtherPrecision;
+template<> struct OtherPrecision<double> { typedef float type; };
+template<> struct OtherPrecision<float> { typedef double type; };
+
+typedef Eigen::Matrix<double, 4, 4, FixedStorage>     Matrix4d;
+typedef Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::DontAlign>
+                                                       Matrix3Xd;
 typedef Eigen::Transform< double, 3, Eigen::Isometry > Isometry3d;
 typedef Eigen::Transform< double, 3, Eigen::Affine > Affine3d;
 typedef Eigen::AngleAxis<double> AngleAxisd;
 
+/* All wrappers below hold their Eigen value by value, so that creating one
+ * from Ruby costs a single allocation (the wrapper itself). Isometry3d and
+ * Affine3d, and the fixed-size types in aligned builds, keep Eigen's default
+ * alignment: the wrappers holding them must use
+ * EIGEN_MAKE_ALIGNED_OPERATOR_NEW, as Rice allocates them with new.
+ */
+
+/* Converts a Ruby numeric into a double
+ *
+ * Float and Integer are converted inline, other numerics go through Rice's
+ * (protected) conversion.
+ */
+static double num2dbl(VALUE value)
+{
+    if (RB_FLOAT_TYPE_P(value))
+        return RFLOAT_VALUE(value);
+    else if (FIXNUM_P(value))
+        return FIX2LONG(value);
+    else
+        return from_ruby<double>(value);
+}
+
+/* Sets the coefficients of a dense Eigen object from a flat Ruby array
+ *
+ * The array may be shorter than the object, in which case the remaining
+ * coefficients are set to zero. nil elements are also set to zero if
+ * nil_as_zero is set, and raise otherwise.
+ */
+template<typename T>
+static void fillFromArray(T& out, Array array, bool column_major, bool nil_as_zero)
+{
+    long size = array.size();
+    if (size > out.size())
+        throw Exception(rb_eArgError, "array should be of size maximum %li, got %li",
+                static_cast<long>(out.size()), size);
+
+    VALUE ary = array.value();
+    long rows = out.rows(), cols = out.cols();
+    for (long i = 0; i < out.size(); ++i)
+    {
+        // The length is read on each iteration, as the conversion of an
+        // element may call Ruby code that shrinks the array
+        double value = 0;
+        if (i < RARRAY_LEN(ary))
+        {
+            VALUE element = RARRAY_AREF(ary, i);
+            if (!NIL_P(element) || !nil_as_zero)
+                value = num2dbl(element);
+        }
+        if (column_major)
+            out(i % rows, i / rows) = value;
+        else
+            out(i / cols, i % cols) = value;
+    }
+}
+
+/* Returns the coefficients of a dense Eigen object as a flat Ruby array */
+template<typename T>
+static Array toArray(T const& in, bool column_major)
+{
+    VALUE result = rb_ary_new_capa(in.size());
+    long rows = in.rows(), cols = in.cols();
+    for (long i = 0; i < in.size(); ++i)
+    {
+        double value = column_major ? in(i % rows, i / rows) : in(i / cols, i % cols);
+        rb_ary_push(result, DBL2NUM(value));
+    }
+    return Array(result);
+}
+
+/* Raises ArgumentError if two objects don't have the same size */
+template<typename A, typename B>
+static void checkSameSize(A const& a, B const& b)
+{
+    if (a.rows() != b.rows() || a.cols() != b.cols())
+        throw Exception(rb_eArgError, "size mismatch: %lix%li and %lix%li",
+                static_cast<long>(a.rows()), static_cast<long>(a.cols()),
+                static_cast<long>(b.rows()), static_cast<long>(b.cols()));
+}
+
+/* Raises ArgumentError on negative dimensions */
+static void checkDimensions(long rows, long cols)
+{
+    if (rows < 0 || cols < 0)
+        throw Exception(rb_eArgError, "invalid dimensions %lix%li", rows, cols);
+}
+
+/* Packed binary representation of the coefficients of a dense object
+ *
+ * The buffer starts with a 16-byte header:
+ *
+ *   - the three characters "EIG", followed by 'l' for a little-endian or 'b'
+ *     for a big-endian buffer
+ *   - the format version, as a 16-bit unsigned integer
+ *   - the size of a scalar in bytes, as a 16-bit unsigned integer
+ *   - the number of rows, as a 32-bit unsigned integer
+ *   - the number of columns, as a 32-bit unsigned integer
+ *
+ * followed by the coefficients in column-major order. The integers and the
+ * coefficients are stored with the buffer's byte order, which is the byte
+ * order of the machine that wrote it. Buffers with the other byte order are
+ * swapped on load.
+ *
+ * This is also the format used by the types' Marshal support.
+ */
+struct BinaryHeader
+{
+    char magic[3];
+    char byte_order;
+    uint16_t version;
+    uint16_t scalar_size;
+    uint32_t rows;
+    uint32_t cols;
+};
+
+static const uint16_t BINARY_FORMAT_VERSION = 1;
+
+static char nativeByteOrder()
+{
+    uint16_t probe = 1;
+    char first;
+    std::memcpy(&first, &probe, 1);
+    return first ? 'l' : 'b';
+}
+
+template<typename T>
+static T byteSwap(T value)
+{
+    char* bytes = reinterpret_cast<char*>(&value);
+    for (unsigned int i = 0; i < sizeof(T) / 2; ++i)
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    return value;
+}
+
+/* Creates a binary buffer from column-major data */
+template<typename Scalar>
+static String toBinary(Scalar const* data, long rows, long cols)
+{
+    BinaryHeader header = { { 'E', 'I', 'G' }, nativeByteOrder(),
+        BINARY_FORMAT_VERSION, sizeof(Scalar),
+        static_cast<uint32_t>(rows), static_cast<uint32_t>(cols) };
+
+    long size = rows * cols * sizeof(Scalar);
+    VALUE result = rb_str_new(NULL, sizeof(header) + size);
+    char* ptr = RSTRING_PTR(result);
+    std::memcpy(ptr, &header, sizeof(header));
+    std::memcpy(ptr + sizeof(header), data, size);
+    return String(result);
+}
+
+/* Validates a binary buffer and returns a pointer to its coefficients
+ *
+ * @param rows set to the number of rows stored in the buffer
+ * @param cols set to the number of columns stored in the buffer
+ * @param swap set to true if the buffer's byte order is not the native one
+ * @tparam Scalar the scalar type the buffer is expected to hold
+ */
+template<typename Scalar = double>
+static char const* readBinaryHeader(String buffer, long& rows, long& cols, bool& swap)
+{
+    VALUE str = buffer.value();
+    long length = RSTRING_LEN(str);
+    char const* ptr = RSTRING_PTR(str);
+
+    BinaryHeader header;
+    if (length < static_cast<long>(sizeof(header)))
+        throw Exception(rb_eArgError, "binary buffer too small (%li bytes)", length);
+    std::memcpy(&header, ptr, sizeof(header));
+    if (std::memcmp(header.magic, "EIG", 3) != 0 ||
+            (header.byte_order != 'l' && header.byte_order != 'b'))
+        throw Exception(rb_eArgError, "not a binary buffer created by to_binary");
+
+    swap = (header.byte_order != nativeByteOrder());
+    if (swap)
+    {
+        header.version = byteSwap(header.version);
+        header.scalar_size = byteSwap(header.scalar_size);
+        header.rows = byteSwap(header.rows);
+        header.cols = byteSwap(header.cols);
+    }
+    if (header.version > BINARY_FORMAT_VERSION)
+        throw Exception(rb_eArgError, "binary buffer has format version %i, this version of the extension supports up to %i",
+                static_cast<int>(header.version), static_cast<int>(BINARY_FORMAT_VERSION));
+    if (header.scalar_size != sizeof(Scalar))
+        throw Exception(rb_eArgError, "expected a buffer of %i-byte scalars, got %i-byte scalars",
+                static_cast<int>(sizeof(Scalar)), static_cast<int>(header.scalar_size));
+
+    uint64_t count = static_cast<uint64_t>(header.rows) * header.cols;
+    uint64_t data_length = length - sizeof(header);
+    if (data_length % sizeof(Scalar) != 0 || data_length / sizeof(Scalar) != count)
+        throw Exception(rb_eArgError, "binary buffer of %li bytes does not match its %ux%u size",
+                length, header.rows, header.cols);
+
+    rows = header.rows;
+    cols = header.cols;
+    return ptr + sizeof(header);
+}
+
+/* Copies the coefficients of a binary buffer, swapping them if needed */
+template<typename Scalar>
+static void copyBinary(Scalar* out, char const* in, long count, bool swap)
+{
+    std::memcpy(out, in, count * sizeof(Scalar));
+    if (swap)
+    {
+        for (long i = 0; i < count; ++i)
+            out[i] = byteSwap(out[i]);
+    }
+}
+
+/* Loads a binary buffer whose size is known in advance */
+template<typename Scalar>
+static void fromBinary(String buffer, Scalar* out, long rows, long cols)
+{
+    long buffer_rows, buffer_cols;
+    bool swap;
+    char const* data = readBinaryHeader<Scalar>(buffer, buffer_rows, buffer_cols, swap);
+    if (buffer_rows != rows || buffer_cols != cols)
+        throw Exception(rb_eArgError, "expected a %lix%li binary buffer, got %lix%li",
+                rows, cols, buffer_rows, buffer_cols);
+    copyBinary(out, data, rows * cols, swap);
+}
+
+/* Estimated number of floating-point operations above which a computation
+ * releases the GVL
+ *
+ * Below this, the cost of releasing and re-acquiring the lock is not worth it
+ */
+static const long NO_GVL_MIN_COST = 1 << 17;
+
+template<typename F>
+static void* callWithoutGVL(void* functor)
+{
+    (*static_cast<F*>(functor))();
+    return NULL;
+}
+
+/* Runs f, releasing the GVL if cost is at least NO_GVL_MIN_COST
+ *
+ * f must not call into Ruby. C++ exceptions it raises are propagated once
+ * the GVL is re-acquired. Objects used by f must be protected with a
+ * NoGVLGuard for the duration of the call.
+ */
+template<typename F>
+static void computeWithoutGVL(long cost, F f)
+{
+    if (cost < NO_GVL_MIN_COST)
+    {
+        f();
+        return;
+    }
+
+    std::exception_ptr error;
+    auto call = [&]() {
+        try { f(); }
+        catch(...) { error = std::current_exception(); }
+    };
+    rb_thread_call_without_gvl(&callWithoutGVL<decltype(call)>, &call, NULL, NULL);
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/* Base class for the objects that can be used by computations running
+ * without the GVL
+ *
+ * Mutating methods must call checkWritable(), which raises while such a
+ * computation is running, since the modification would happen concurrently
+ * with it. It also raises while the object's memory is exported through a
+ * memory view, since a reallocation would leave the view dangling.
+ *
+ * Methods reading the coefficients from Ruby must call checkReadable(),
+ * which raises while a computation writes into the object.
+ */
+struct NoGVLUsage
+{
+    mutable int no_gvl_users;
+    mutable int no_gvl_writers;
+    mutable int exported_views;
+
+    NoGVLUsage() : no_gvl_users(0), no_gvl_writers(0), exported_views(0) {}
+    NoGVLUsage(NoGVLUsage const&) : no_gvl_users(0), no_gvl_writers(0), exported_views(0) {}
+    NoGVLUsage& operator =(NoGVLUsage const&) { return *this; }
+
+    void checkReadable() const
+    {
+        if (no_gvl_writers)
+            throw Exception(rb_eRuntimeError,
+                    "cannot read an object that is being modified by a computation in another thread");
+    }
+
+    void checkWritable() const
+    {
+        if (no_gvl_users)
+            throw Exception(rb_eRuntimeError,
+                    "cannot modify an object that is in use by a computation in another thread");
+        if (exported_views)
+            throw Exception(rb_eRuntimeError,
+                    "cannot modify an object whose memory is exported, release its memory views first");
+    }
+};
+
+/* Marks an object as in use for the lifetime of the guard
+ *
+ * Guards with write set mark the object as being modified, which makes
+ * checkReadable() and the creation of further guards on it raise. They must
+ * therefore be created after the read guards of the same computation.
+ */
+struct NoGVLGuard
+{
+    NoGVLUsage const& object;
+    bool write;
+    NoGVLGuard(NoGVLUsage const& object, bool write = false)
+        : object(object), write(write)
+    {
+        object.checkReadable();
+        ++object.no_gvl_users;
+        if (write)
+            ++object.no_gvl_writers;
+    }
+    ~NoGVLGuard()
+    {
+        --object.no_gvl_users;
+        if (write)
+            --object.no_gvl_writers;
+    }
+};
+
+/* Evaluates a scalar reduction of owner's coefficients, without the GVL if
+ * cost is high enough */
+template<typename F>
+static double reduceWithoutGVL(NoGVLUsage const& owner, long cost, F f)
+{
+    double result = 0;
+    NoGVLGuard guard(owner);
+    computeWithoutGVL(cost, [&]() { result = f(); });
+    return result;
+}
+
+/* Raises ArgumentError for reductions that are undefined on empty objects */
+template<typename T>
+static void checkNotEmpty(T const& m, char const* operation)
+{
+    if (m.size() == 0)
+        throw Exception(rb_eArgError, "cannot compute the %s of an empty object", operation);
+}
+
+/* Raises ArgumentError if p is not a valid exponent for lpNorm */
+static void checkNormExponent(double p)
+{
+    if (!(p >= 1))
+        throw Exception(rb_eArgError, "the exponent of a Lp norm must be greater or equal to 1, got %f", p);
+}
+
+/* The Lp norm of a dense object, with p >= 1 or infinite */
+template<typename T>
+static double lpNorm(T const& m, double p)
+{
+    typedef typename T::Scalar Scalar;
+    if (m.size() == 0)
+        return 0;
+    else if (p == 1)
+        return m.template lpNorm<1>();
+    else if (p == 2)
+        return m.norm();
+    else if (std::isinf(p))
+        return m.template lpNorm<Eigen::Infinity>();
+    else
+        return std::pow(m.array().abs().pow(static_cast<Scalar>(p)).sum(), 1 / p);
+}
+
+/* Second operand of a coefficient-wise operation on a dense object: either a
+ * scalar, broadcast to the object's size, or an object of the same type and
+ * size. The latter cannot be modified while the operand exists */
+template<typename Wrapper>
+struct CwiseOperand
+{
+    typedef typename Wrapper::EigenType EigenType;
+    typedef typename EigenType::Scalar Scalar;
+
+    EigenType const* eigen;
+    Scalar constant;
+    long rows, cols;
+    std::unique_ptr<NoGVLGuard> guard;
+
+    CwiseOperand(Object value, EigenType const& self, EigenType Wrapper::*storage)
+        : eigen(nullptr), constant(0), rows(self.rows()), cols(self.cols())
+    {
+        if (rb_obj_is_kind_of(value.value(), rb_cNumeric))
+        {
+            constant = static_cast<Scalar>(num2dbl(value.value()));
+            return;
+        }
+
+        Wrapper const* other = Data_Type<Wrapper>::from_ruby(value);
+        checkSameSize(self, other->*storage);
+        eigen = &(other->*storage);
+        guard.reset(new NoGVLGuard(*other));
+    }
+
+    /* Calls g with the operand as an array expression. Scalars are passed as
+     * a constant expression, which allocates nothing */
+    template<typename G>
+    void visit(G g) const
+    {
+        if (eigen)
+            g(eigen->array());
+        else
+            g(EigenType::Constant(rows, cols, constant).array());
+    }
+};
+
+/* Evaluates an array expression of the coefficients of in into out, without
+ * the GVL on large objects. in and out may be the same object */
+template<typename Storage, typename F>
+static void cwiseApply(NoGVLUsage const& owner, Storage const& in, Storage& out, F f)
+{
+    NoGVLGuard guard(owner, &in == &out);
+    computeWithoutGVL(in.size(), [&]() { out = f(in.array()).matrix(); });
+}
+
+/* Raises ArgumentError if [min, max] is not a valid clamping interval */
+static void checkClampBounds(double min, double max)
+{
+    if (!(min <= max))
+        throw Exception(rb_eArgError, "invalid clamping interval [%f, %f]", min, max);
+}
+
+/* Raises ArgumentError if there are not enough observations to estimate a
+ * covariance */
+static void checkObservationCount(long count)
+{
+    if (count < 2)
+        throw Exception(rb_eArgError, "need at least 2 observations to compute a covariance, got %li", count);
+}
+
+/* computeCovariance for a dynamic dimension, through a product of the
+ * centered observations */
+template<typename Input, typename Output>
+static void computeCovariance(Input const& observations, Output& result, std::false_type)
+{
+    typedef typename Input::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Centered;
+    Centered centered = observations.colwise() - observations.rowwise().mean();
+    result.noalias() = centered * centered.transpose();
+    result /= static_cast<Scalar>(observations.cols() - 1);
+}
+
+/* computeCovariance for a fixed dimension, accumulating the scatter matrix
+ * one observation at a time so that nothing is allocated on the heap */
+template<typename Input, typename Output>
+static void computeCovariance(Input const& observations, Output& result, std::true_type)
+{
+    typedef typename Input::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Input::RowsAtCompileTime, 1> Point;
+    typedef Eigen::Matrix<Scalar, Input::RowsAtCompileTime, Input::RowsAtCompileTime> Scatter;
+    Point mean = observations.rowwise().mean();
+    Scatter scatter = Scatter::Zero();
+    for (long i = 0; i < observations.cols(); ++i)
+    {
+        Point centered = observations.col(i) - mean;
+        scatter.noalias() += centered * centered.transpose();
+    }
+    result = scatter / static_cast<Scalar>(observations.cols() - 1);
+}
+
+/* Sample covariance of the observations stored as the columns of
+ * observations */
+template<typename Input, typename Output>
+static void computeCovariance(Input const& observations, Output& result)
+{
+    computeCovariance(observations, result,
+            std::integral_constant<bool, Input::RowsAtCompileTime != Eigen::Dynamic>());
+}
+
+/* Above this dimension, principal components are computed from the SVD of
+ * the centered observations rather than from the eigendecomposition of
+ * their covariance */
+static const int PCA_EIGENSOLVER_MAX_DIMENSION = 16;
+
+/* Principal axes (as columns) and variances of the observations stored as
+ * the columns of observations, by decreasing variance */
+template<typename Input>
+static void computePrincipalComponents(Input const& observations, int k,
+        Eigen::MatrixXd& axes, Eigen::VectorXd& variances)
+{
+    typedef Eigen::Matrix<double, Input::RowsAtCompileTime, Input::RowsAtCompileTime> Covariance;
+    long dim = observations.rows();
+    long count = observations.cols();
+    if (dim <= PCA_EIGENSOLVER_MAX_DIMENSION)
+    {
+        Covariance covariance(dim, dim);
+        computeCovariance(observations, covariance);
+        Eigen::SelfAdjointEigenSolver<Covariance> solver(covariance);
+        // The eigenvalues are sorted in increasing order
+        axes = solver.eigenvectors().rowwise().reverse().leftCols(k);
+        variances = solver.eigenvalues().reverse().head(k).cwiseMax(0.0);
+    }
+    else
+    {
+        Eigen::MatrixXd centered = observations.colwise() - observations.rowwise().mean();
+        int flags = k <= std::min(dim, count) ? Eigen::ComputeThinU : Eigen::ComputeFullU;
+        Eigen::BDCSVD<Eigen::MatrixXd> svd(centered, flags);
+        axes = svd.matrixU().leftCols(k);
+        long available = std::min<long>(k, svd.singularValues().size());
+        variances = Eigen::VectorXd::Zero(k);
+        variances.head(available) =
+            (svd.singularValues().head(available).array().square() / static_cast<double>(count - 1)).matrix();
+    }
+}
+
+/* Total of the payload sizes currently reported to Ruby's GC */
+static long total_reported_memsize = 0;
+
+/* Base class for the objects whose heap payload can be reported to Ruby's
+ * GC with rb_gc_adjust_memory_usage
+ *
+ * Reporting is done by the instrumentation (see Eigen.stats), only when it
+ * is enabled. What has been reported is given back when the object is
+ * destroyed.
+ */
+struct ReportedMemsize
+{
+    mutable long reported_memsize;
+
+    ReportedMemsize() : reported_memsize(0) {}
+    ReportedMemsize(ReportedMemsize const&) : reported_memsize(0) {}
+    ReportedMemsize& operator =(ReportedMemsize const&) { return *this; }
+    ~ReportedMemsize() { updateReportedMemsize(0); }
+
+    void updateReportedMemsize(size_t payload) const
+    {
+        long diff = static_cast<long>(payload) - reported_memsize;
+        if (!diff)
+            return;
+        rb_gc_adjust_memory_usage(diff);
+        reported_memsize += diff;
+        total_reported_memsize += diff;
+    }
+};
+
+/* Memory used by an object without heap payload */
+template<typename T>
+static size_t fixedMemsize(Object /* self */)
+{ return sizeof(T); }
+
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+/* Read access to the memory view exported by another object
+ *
+ * Only one or two-dimensional views of native-endian doubles or floats are
+ * accepted. The view is released on destruction.
+ */
+struct MemoryViewReader
+{
+    rb_memory_view_t view;
+    char format;
+    ssize_t shape[2];
+    ssize_t strides[2];
+
+    MemoryViewReader(Object object)
+    {
+        if (!rb_memory_view_get(object.value(), &view, RUBY_MEMORY_VIEW_FORMAT | RUBY_MEMORY_VIEW_STRIDES))
+            throw Exception(rb_eTypeError, "%s does not export a memory view",
+                    rb_obj_classname(object.value()));
+
+        try { parse(); }
+        catch(...)
+        {
+            rb_memory_view_release(&view);
+            throw;
+        }
+    }
+    ~MemoryViewReader() { rb_memory_view_release(&view); }
+
+    void parse()
+    {
+        rb_memory_view_item_component_t* components = nullptr;
+        size_t count = 0;
+        ssize_t item_size = rb_memory_view_parse_item_format(
+                view.format ? view.format : "C", &components, &count, nullptr);
+        format = 0;
+        if (item_size > 0 && count == 1 && components[0].repeat == 1 &&
+                components[0].little_endian_p == (nativeByteOrder() == 'l'))
+            format = components[0].format;
+        xfree(components);
+
+        if ((format != 'd' && format != 'f') || item_size != view.item_size)
+            throw Exception(rb_eArgError, "expected a memory view of native-endian doubles or floats, got format '%s'",
+                    view.format ? view.format : "C");
+        if (view.ndim != 1 && view.ndim != 2)
+            throw Exception(rb_eArgError, "expected a memory view with one or two dimensions, got %li",
+                    static_cast<long>(view.ndim));
+
+        for (int i = 0; i < view.ndim; ++i)
+            shape[i] = view.shape ? view.shape[i] : view.byte_size / view.item_size;
+        if (view.strides)
+            std::copy(view.strides, view.strides + view.ndim, strides);
+        else
+            rb_memory_view_fill_contiguous_strides(view.ndim, view.item_size, shape, true, strides);
+        if (view.ndim == 1)
+        {
+            shape[1] = 1;
+            strides[1] = 0;
+        }
+
+        // Verify that the strides do not reach outside of the exported memory
+        if (shape[0] == 0 || shape[1] == 0)
+            return;
+        ssize_t min_offset = 0, max_offset = 0;
+        for (int i = 0; i < 2; ++i)
+        {
+            ssize_t offset = (shape[i] - 1) * strides[i];
+            (offset < 0 ? min_offset : max_offset) += offset;
+        }
+        if (min_offset < 0 || max_offset + view.item_size > view.byte_size)
+            throw Exception(rb_eArgError, "the shape and strides of the memory view reach outside of its %li bytes",
+                    static_cast<long>(view.byte_size));
+    }
+
+    long rows() const { return shape[0]; }
+    long cols() const { return shape[1]; }
+
+    /* Copies the coefficients into an Eigen object of size rows() x cols() */
+    template<typename T>
+    void copyTo(T& out) const
+    {
+        if (format == 'd')
+            copyAs<double>(out);
+        else
+            copyAs<float>(out);
+    }
+
+    template<typename Source, typename T>
+    void copyAs(T& out) const
+    {
+        char const* data = static_cast<char const*>(view.data);
+        for (long j = 0; j < cols(); ++j)
+        {
+            for (long i = 0; i < rows(); ++i)
+            {
+                Source value;
+                std::memcpy(&value, data + i * strides[0] + j * strides[1], sizeof(Source));
+                out(i, j) = value;
+            }
+        }
+    }
+};
+#endif
+
+/* Maximum number of threads used by parallelFor and, if the extension is
+ * built with OpenMP, by Eigen's own kernels. See Eigen.threads= */
+static long max_threads = 1;
+
+/* Minimum number of items each thread should process in parallelFor */
+static const long PARALLEL_MIN_ITEMS_PER_THREAD = 32768;
+
+/* Calls f(begin, end) on contiguous slices of [0, count), in parallel if
+ * count is large enough to make it worth starting threads
+ *
+ * f must not call into Ruby
+ */
+template<typename F>
+static void parallelFor(long count, F f)
+{
+    long thread_count = std::min(max_threads, count / PARALLEL_MIN_ITEMS_PER_THREAD);
+    if (thread_count <= 1)
+    {
+        f(0, count);
+        return;
+    }
+
+    // Joins the started threads however this function exits, destroying
+    // a joinable std::thread terminates the process
+    struct Threads : std::vector<std::thread>
+    {
+        ~Threads()
+        {
+            for (std::thread& t : *this)
+                t.join();
+        }
+    };
+
+    long slice = (count + thread_count - 1) / thread_count;
+    Threads threads;
+    threads.reserve(thread_count - 1);
+    long begin = slice;
+    try
+    {
+        for (; begin < count; begin += slice)
+            threads.emplace_back(f, begin, std::min(count, begin + slice));
+    }
+    catch (std::system_error const&)
+    {
+        // Could not start a thread, process the remaining slices here
+    }
+    for (; begin < count; begin += slice)
+        f(begin, std::min(count, begin + slice));
+    f(0, slice);
+}
+
+/* Applies an affine transformation on the columns of a 3xN matrix
+ *
+ * The points are processed in blocks through a fixed-size temporary, so that
+ * the product vectorizes, does not allocate, and in and out may be the same
+ * buffer.
+ */
+template<typename In, typename Out>
+static void transformPoints(Eigen::Matrix3d const& linear, Eigen::Vector3d const& translation,
+        In const& in, Out& out, long begin, long end)
+{
+    static const int BLOCK = 64;
+    Eigen::Matrix<double, 3, BLOCK> block;
+    for (long i = begin; i < end; i += BLOCK)
+    {
+        long n = std::min<long>(BLOCK, end - i);
+        block.leftCols(n).noalias() = linear * in.middleCols(i, n);
+        out.middleCols(i, n) = block.leftCols(n).colwise() + translation;
+    }
+}
+
+/* Sets out to sum(coefficients[i] * operands[i]), in a single pass
+ *
+ * This is the evaluation of Eigen::LazyExpression. Sums of up to four terms
+ * are expanded into one Eigen expression, so the result is written once
+ * and no temporary is allocated. Longer sums add three more terms per pass.
+ * out may be one of the operands, as the expressions are coefficient-wise:
+ * the terms that read out are moved to the first pass, and if there are
+ * more than four of them the sum is evaluated in a temporary.
+ *
+ * @param storage pointer to the Eigen member of Wrapper
+ */
+template<typename Wrapper, typename Storage>
+static void assignLinear(Wrapper& out, Storage Wrapper::* storage, Array coefficients, Array operands)
+{
+    typedef typename Storage::Scalar Scalar;
+    long count = operands.size();
+    if (count == 0)
+        throw Exception(rb_eArgError, "expected at least one operand");
+    if (coefficients.size() != count)
+        throw Exception(rb_eArgError, "got %li coefficients for %li operands",
+                static_cast<long>(coefficients.size()), count);
+
+    std::vector<Scalar> c(count);
+    std::vector<Wrapper const*> x(count);
+    for (long i = 0; i < count; ++i)
+    {
+        c[i] = num2dbl(RARRAY_AREF(coefficients.value(), i));
+        x[i] = Data_Type<Wrapper>::from_ruby(RARRAY_AREF(operands.value(), i));
+        checkSameSize(x[0]->*storage, x[i]->*storage);
+    }
+
+    // Later passes read the operands after the first one wrote out
+    long aliased = 0;
+    for (long i = 0; i < count; ++i)
+    {
+        if (x[i] == &out)
+        {
+            std::swap(c[i], c[aliased]);
+            std::swap(x[i], x[aliased]);
+            ++aliased;
+        }
+    }
+
+    out.checkWritable();
+    Storage const& first = x[0]->*storage;
+    Storage temporary;
+    Storage& result = aliased > 4 ? temporary : out.*storage;
+    if (result.rows() != first.rows() || result.cols() != first.cols())
+        result.resize(first.rows(), first.cols());
+
+    // out is written in place unless the temporary is used, its guard comes
+    // last as it may also be an operand
+    std::vector<std::unique_ptr<NoGVLGuard> > guards;
+    for (long i = 0; i < count; ++i)
+        guards.emplace_back(new NoGVLGuard(*x[i]));
+    guards.emplace_back(new NoGVLGuard(out, &result != &temporary));
+
+    // The expressions only reference the operands, which outlive them
+    auto term = [&](long i) { return c[i] * (x[i]->*storage); };
+    computeWithoutGVL(first.size() * count, [&]() {
+        switch (count)
+        {
+            case 1: result = term(0); return;
+            case 2: result = term(0) + term(1); return;
+            case 3: result = term(0) + term(1) + term(2); return;
+            default: result = term(0) + term(1) + term(2) + term(3);
+        }
+
+        long i = 4;
+        for (; i + 3 <= count; i += 3)
+            result += term(i) + term(i + 1) + term(i + 2);
+        if (count - i == 2)
+            result += term(i) + term(i + 1);
+        else if (count - i == 1)
+            result += term(i);
+    });
+    if (&result == &temporary)
+        (out.*storage).swap(temporary);
+}
+
 /* 
  * Document-class: Eigen::Vector3
  *
@@ -88,6 +939,18 @@ typedef Eigen::AngleAxis<double> AngleAxisd;
  * @!method -@()
  *    Negation
  *    @return [Vector3] the result
+ * @!method add!(v)
+ *    In-place sum
+ *    @param [Vector3] v
+ *    @return [void]
+ * @!method sub!(v)
+ *    In-place subtraction
+ *    @param [Vector3] v
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
  * @!method cross(v)
  *    Cross product
  *    @param [VectorX] v
@@ -100,56 +963,90 @@ typedef Eigen::AngleAxis<double> AngleAxisd;
  *    Verifies that two vectors are within threshold of each other, elementwise
  *    @param [Vector3]
  *    @return [Boolean]
+ * @!method to_binary
+ *   Returns the coefficients as a packed binary string
+ *   @return [String]
+ * @!method from_binary(buffer)
+ *   Sets the coefficients from a string created by {#to_binary}
+ *   @param [String] buffer
+ *   @return [void]
+ * @!method to_single
+ *   Converts to single precision
+ *   @return [Vector3f]
  */
 
-struct Vector3
-{
-    Vector3d* v;
-
-    Vector3(double x, double y, double z)
-        : v(new Vector3d(x, y, z)) {}
-    Vector3(Vector3d const& _v)
-        : v(new Vector3d(_v)) {}
-    ~Vector3()
-    { delete v; }
-
-    double x() const { return v->x(); }
-    double y() const { return v->y(); }
-    double z() const { return v->z(); }
-    void setX(double value) { v->x() = value; }
-    void setY(double value) { v->y() = value; }
-    void setZ(double value) { v->z() = value; }
-
-
-    double norm() const { return v->norm(); }
-    Vector3* normalize() const { return new Vector3(v->normalized()); }
-    void normalizeBang() const { v->normalize(); }
-
-    double get(int i) const { return (*v)[i]; }
-    void set(int i, double value) { (*v)[i] = value; }
-
-    Vector3* operator + (Vector3 const& other) const
-    { return new Vector3(*v + *other.v); }
-    Vector3* operator - (Vector3 const& other) const
-    { return new Vector3(*v - *other.v); }
-
-    Vector3* operator / (double scalar) const
-    { return new Vector3(*v / scalar); }
-
-    Vector3* negate() const
-    { return new Vector3(-*v); }
-    Vector3* scale(double value) const
-    { return new Vector3(*v * value); }
-    double dot(Vector3 const& other) const
-    { return this->v->dot(*other.v); }
-    Vector3* cross(Vector3 const& other) const
-    { return new Vector3(this->v->cross(*other.v)); }
-    bool operator ==(Vector3 const& other) const
-    { return (*this->v) == (*other.v); }
-    bool isApprox(Vector3 const& other, double tolerance)
-    { return v->isApprox(*other.v, tolerance); }
+template<typename Scalar>
+struct BasicVector3
+{
+    typedef EigenVector3<Scalar> EigenType;
+    EigenType v;
+
+    BasicVector3(double x, double y, double z)
+        : v(x, y, z) {}
+    BasicVector3(EigenType const& _v)
+        : v(_v) {}
+
+    double x() const { return v.x(); }
+    double y() const { return v.y(); }
+    double z() const { return v.z(); }
+    void setX(double value) { v.x() = value; }
+    void setY(double value) { v.y() = value; }
+    void setZ(double value) { v.z() = value; }
+
+
+    double norm() const { return v.norm(); }
+    BasicVector3* normalize() const { return new BasicVector3(v.normalized()); }
+    void normalizeBang() { v.normalize(); }
+
+    double get(int i) const { return v[i]; }
+    void set(int i, double value) { v[i] = value; }
+
+    String toBinary() const { return ::toBinary(v.data(), 3, 1); }
+    void fromBinary(String buffer) { ::fromBinary(buffer, v.data(), 3, 1); }
+
+    BasicVector3* operator + (BasicVector3 const& other) const
+    { return new BasicVector3(v + other.v); }
+    BasicVector3* operator - (BasicVector3 const& other) const
+    { return new BasicVector3(v - other.v); }
+
+    BasicVector3* operator / (double scalar) const
+    { return new BasicVector3(v / scalar); }
+
+    BasicVector3* negate() const
+    { return new BasicVector3(-v); }
+    BasicVector3* scale(double value) const
+    { return new BasicVector3(v * value); }
+
+    void addBang(BasicVector3 const& other) { v += other.v; }
+    void subBang(BasicVector3 const& other) { v -= other.v; }
+    void scaleBang(double value) { v *= value; }
+    double dot(BasicVector3 const& other) const
+    { return v.dot(other.v); }
+    BasicVector3* cross(BasicVector3 const& other) const
+    { return new BasicVector3(v.cross(other.v)); }
+    bool operator ==(BasicVector3 const& other) const
+    { return v == other.v; }
+    bool isApprox(BasicVector3 const& other, double tolerance)
+    { return v.isApprox(other.v, tolerance); }
+
+    typedef BasicVector3<typename OtherPrecision<Scalar>::type> Converted;
+    Converted* convert() const
+    { return new Converted(v.template cast<typename OtherPrecision<Scalar>::type>()); }
 };
 
+typedef BasicVector3<double> Vector3;
+typedef BasicVector3<float> Vector3f;
+
+/*
+ * Document-class: Eigen::Vector3f
+ *
+ * Single-precision version of {Eigen::Vector3}, with the same API.
+ *
+ * @!method to_double
+ *   Converts to double precision
+ *   @return [Vector3]
+ */
+
 /* 
  * Document-class: Eigen::VectorX
  *
@@ -174,6 +1071,10 @@ struct Vector3
  * @!method size
  *   Returns the vector's size
  *   @return [Integer]
+ * @!method memsize
+ *   Returns the number of bytes used by the vector, including its
+ *   coefficients
+ *   @return [Integer]
  * @!method [](index)
  *   Returns an element
  *   @param [Integer] index the element index (0, 1 or 2)
@@ -183,6 +1084,13 @@ struct Vector3
  *   @param [Integer] index the element index (0, 1 or 2)
  *   @param [Numeric] value
  *   @return [Numeric]
+ * @!method from_a(array)
+ *   Resizes self to the array's size and sets its elements
+ *   @param [Array<Numeric>] array
+ *   @return [void]
+ * @!method to_a
+ *   Returns the vector elements
+ *   @return [Array<Float>]
  * @!method +(v)
  *    Sum
  *    @param [VectorX] v
@@ -202,65 +1110,630 @@ struct Vector3
  * @!method -@()
  *    Negation
  *    @return [VectorX] the result
+ * @!method add!(v)
+ *    In-place sum
+ *    @param [VectorX] v
+ *    @return [void]
+ * @!method sub!(v)
+ *    In-place subtraction
+ *    @param [VectorX] v
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
+ * @!method segment(start, size)
+ *    Returns a view of a contiguous part of this vector. Writes to the
+ *    view modify self
+ *    @param [Integer] start
+ *    @param [Integer] size
+ *    @return [VectorXView]
+ * @!method head(size)
+ *    Returns a view of the first elements, see {#segment}
+ *    @param [Integer] size
+ *    @return [VectorXView]
+ * @!method tail(size)
+ *    Returns a view of the last elements, see {#segment}
+ *    @param [Integer] size
+ *    @return [VectorXView]
+ * @!method mul_into!(m, v, alpha = 1, beta = 0)
+ *    Sets self to alpha * m * v + beta * self, without allocating if self
+ *    already has the right size
+ *    @param [MatrixX] m
+ *    @param [VectorX] v
+ *    @param [Numeric] alpha
+ *    @param [Numeric] beta
+ *    @return [void]
  * @!method dot(v)
  *    Dot product
  *    @param [VectorX] v
  *    @return [VectorX] the result
+ * @!method sum
+ *    Sum of the coefficients
+ *    @return [Float]
+ * @!method mean
+ *    Mean of the coefficients
+ *    @return [Float]
+ *    @raise [ArgumentError] if the vector is empty
+ * @!method min
+ *    Smallest coefficient
+ *    @return [Float]
+ *    @raise [ArgumentError] if the vector is empty
+ * @!method max
+ *    Largest coefficient
+ *    @return [Float]
+ *    @raise [ArgumentError] if the vector is empty
+ * @!method argmin
+ *    Index of the smallest coefficient
+ *    @return [Integer]
+ *    @raise [ArgumentError] if the vector is empty
+ * @!method argmax
+ *    Index of the largest coefficient
+ *    @return [Integer]
+ *    @raise [ArgumentError] if the vector is empty
+ * @!method squared_norm
+ *    Squared euclidean norm, cheaper than squaring {#norm}
+ *    @return [Float]
+ * @!method lp_norm(p)
+ *    Lp norm, i.e. (sum |x_i|^p)^(1/p)
+ *    @param [Float] p the exponent, greater or equal to 1. Pass
+ *      Float::INFINITY for the largest absolute value
+ *    @return [Float]
+ * @!method cwise_abs
+ *    Coefficient-wise absolute value. {#cwise_sqrt}, {#cwise_exp},
+ *    {#cwise_log}, {#cwise_square} and {#cwise_inverse} (1/x) are the
+ *    other coefficient-wise functions. Each has an in-place variant, e.g.
+ *    {#cwise_abs!}
+ *    @return [VectorX]
+ * @!method cwise_product(other)
+ *    Coefficient-wise product. {#cwise_quotient}, {#cwise_min} and
+ *    {#cwise_max} are the other coefficient-wise binary operations. Each
+ *    has an in-place variant, e.g. {#cwise_product!}
+ *    @param [VectorX,Numeric] other a vector of the same size, or a scalar
+ *      applied to all coefficients
+ *    @return [VectorX]
+ * @!method cwise_clamp(min, max)
+ *    Clamps each coefficient to [min, max], see also {#cwise_clamp!}
+ *    @param [Numeric] min
+ *    @param [Numeric] max
+ *    @return [VectorX]
+ * @!method cwise_select(then_value, else_value)
+ *    Takes the coefficients of then_value where self is non-zero, of
+ *    else_value elsewhere
+ *    @param [VectorX,Numeric] then_value
+ *    @param [VectorX,Numeric] else_value
+ *    @return [VectorX]
+ * @!method set_zero(size)
+ *    Resizes the vector and sets all its coefficients to zero
+ *    @param [Integer] size
+ *    @return [void]
+ * @!method set_constant(size, value)
+ *    Resizes the vector and sets all its coefficients to value
+ *    @param [Integer] size
+ *    @param [Numeric] value
+ *    @return [void]
+ * @!method set_random(size)
+ *    Resizes the vector and sets its coefficients to random values in
+ *    [-1, 1]. They come from the C library's rand(), which Kernel#srand
+ *    does not seed
+ *    @param [Integer] size
+ *    @return [void]
  * @!method approx?(v, threshold = dummy_precision)
  *    Verifies that two vectors are within threshold of each other, elementwise
  *    @param [VectorX]
  *    @return [Boolean]
+ * @!method to_binary
+ *   Returns the coefficients as a packed binary string
+ *   @return [String]
+ * @!method from_binary(buffer)
+ *   Resizes self and sets its coefficients from a string created by
+ *   {#to_binary}
+ *   @param [String] buffer
+ *   @return [void]
+ * @!method from_memory_view(object)
+ *   Resizes self and copies the coefficients of an object that exports a
+ *   one-dimensional memory view of doubles or floats, or a two-dimensional
+ *   one with a single row or column. The vector itself exports a memory
+ *   view of its coefficients, during which it cannot be modified from Ruby.
+ *   @param [Object] object
+ *   @return [void]
+ * @!method to_single
+ *   Converts to single precision
+ *   @return [VectorXf]
  */
-struct VectorX {
+template<typename Scalar> struct BasicMatrixX;
 
-    VectorXd* v;
+template<typename Scalar>
+struct BasicVectorX : NoGVLUsage, ReportedMemsize {
+
+    typedef EigenVectorX<Scalar> EigenType;
+    EigenType v;
     
-    VectorX()
-        : v(new VectorXd()) {}
-    VectorX(VectorX const& v)
-        : v(new VectorXd(*v.v)) {}
-    VectorX(int n)
-        : v(new VectorXd(n)) {}
-    VectorX(VectorXd const& _v)
-        : v(new VectorXd(_v)) {}
-    ~VectorX()
-    { delete v; }
+    BasicVectorX() {}
+    BasicVectorX(BasicVectorX const& v)
+        : v(v.v) {}
+    BasicVectorX(int n)
+        : v(n) {}
+    BasicVectorX(EigenType const& _v)
+        : v(_v) {}
     
-    void resize(int n) { v->resize(n); }
-    void conservativeResize(int n) { v->conservativeResize(n); }
+    void resize(int n) { checkWritable(); v.resize(n); }
+    void conservativeResize(int n) { checkWritable(); v.conservativeResize(n); }
 
-    double norm() const { return v->norm(); }
-    VectorX* normalize() const { return new VectorX(v->normalized()); }
-    void normalizeBang() const { v->normalize(); }
+    size_t payloadSize() const { return v.size() * sizeof(Scalar); }
+    size_t memsize() const { return sizeof(*this) + payloadSize(); }
+    void reportMemsize() const { updateReportedMemsize(payloadSize()); }
 
-    unsigned int size() { return v->size(); }
+    double norm() const { return v.norm(); }
+    BasicVectorX* normalize() const { return new BasicVectorX(v.normalized()); }
+    void normalizeBang() { checkWritable(); v.normalize(); }
 
-    double get(int i) const { return (*v)[i]; }
-    void set(int i, double value) { (*v)[i] = value; }
+    unsigned int size() { return v.size(); }
 
-    VectorX* operator + (VectorX const& other) const
-    { return new VectorX(*v + *other.v); }
-    VectorX* operator - (VectorX const& other) const
-    { return new VectorX(*v - *other.v); }
+    double get(int i) const { checkReadable(); return v[i]; }
+    void set(int i, double value) { checkWritable(); v[i] = value; }
 
-    VectorX* operator / (double scalar) const
-    { return new VectorX(*v / scalar); }
-    
-    VectorX* negate() const
-    { return new VectorX(-*v); }
+    void fromArray(Array array)
+    {
+        checkWritable();
+        v.resize(array.size());
+        fillFromArray(v, array, true, false);
+    }
+    Array toArray() const { checkReadable(); return ::toArray(v, true); }
 
-    VectorX* scale(double value) const
-    { return new VectorX(*v * value); }
+    String toBinary() const { checkReadable(); return ::toBinary(v.data(), v.size(), 1); }
+    void fromBinary(String buffer)
+    {
+        checkWritable();
+        long rows, cols;
+        bool swap;
+        char const* data = readBinaryHeader<Scalar>(buffer, rows, cols, swap);
+        if (cols != 1)
+            throw Exception(rb_eArgError, "expected a binary buffer with one column, got %li", cols);
+        v.resize(rows);
+        copyBinary(v.data(), data, rows, swap);
+    }
 
-    double dot(VectorX const& other) const
-    { return this->v->dot(*other.v); }
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+    void fromMemoryView(Object object)
+    {
+        checkWritable();
+        MemoryViewReader reader(object);
+        if (reader.rows() != 1 && reader.cols() != 1)
+            throw Exception(rb_eArgError, "expected a memory view with a single row or column, got %lix%li",
+                    reader.rows(), reader.cols());
+        v.resize(reader.rows() * reader.cols());
+        Eigen::Map<Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>> out(v.data(), reader.rows(), reader.cols());
+        reader.copyTo(out);
+    }
+#endif
+
+    BasicVectorX* operator + (BasicVectorX const& other) const
+    { return new BasicVectorX(v + other.v); }
+    BasicVectorX* operator - (BasicVectorX const& other) const
+    { return new BasicVectorX(v - other.v); }
+
+    BasicVectorX* operator / (double scalar) const
+    { return new BasicVectorX(v / scalar); }
+    
+    BasicVectorX* negate() const
+    { return new BasicVectorX(-v); }
+
+    BasicVectorX* scale(double value) const
+    { return new BasicVectorX(v * value); }
+
+    void addBang(BasicVectorX const& other)
+    {
+        checkWritable();
+        checkSameSize(v, other.v);
+        v += other.v;
+    }
+    void subBang(BasicVectorX const& other)
+    {
+        checkWritable();
+        checkSameSize(v, other.v);
+        v -= other.v;
+    }
+    void scaleBang(double value) { checkWritable(); v *= value; }
+
+    void mulInto(BasicMatrixX<Scalar> const& m, BasicVectorX const& other, double alpha, double beta);
+
+    void assignLinearCombination(Array coefficients, Array operands)
+    { assignLinear(*this, &BasicVectorX::v, coefficients, operands); }
+
+    double dot(BasicVectorX const& other) const
+    { return v.dot(other.v); }
+
+    double sum() const
+    { return reduceWithoutGVL(*this, v.size(), [&]() { return v.sum(); }); }
+    double mean() const
+    {
+        checkNotEmpty(v, "mean");
+        return reduceWithoutGVL(*this, v.size(), [&]() { return v.mean(); });
+    }
+    double minCoeff() const
+    {
+        checkNotEmpty(v, "minimum");
+        return reduceWithoutGVL(*this, v.size(), [&]() { return v.minCoeff(); });
+    }
+    double maxCoeff() const
+    {
+        checkNotEmpty(v, "maximum");
+        return reduceWithoutGVL(*this, v.size(), [&]() { return v.maxCoeff(); });
+    }
+    int argmin() const
+    {
+        checkNotEmpty(v, "minimum");
+        Eigen::Index index;
+        reduceWithoutGVL(*this, v.size(), [&]() { return v.minCoeff(&index); });
+        return index;
+    }
+    int argmax() const
+    {
+        checkNotEmpty(v, "maximum");
+        Eigen::Index index;
+        reduceWithoutGVL(*this, v.size(), [&]() { return v.maxCoeff(&index); });
+        return index;
+    }
+    double squaredNorm() const
+    { return reduceWithoutGVL(*this, v.size(), [&]() { return v.squaredNorm(); }); }
+    double lpNorm(double p) const
+    {
+        checkNormExponent(p);
+        return reduceWithoutGVL(*this, v.size(), [&]() { return ::lpNorm(v, p); });
+    }
+
+    void setZero(int n) { checkDimensions(n, 1); checkWritable(); v.setZero(n); }
+    void setConstant(int n, double value) { checkDimensions(n, 1); checkWritable(); v.setConstant(n, value); }
+    void setRandom(int n) { checkDimensions(n, 1); checkWritable(); v.setRandom(n); }
+
+    /* Coefficient-wise operations, through Eigen's array API */
+    template<typename F>
+    BasicVectorX* cwiseMap(F f) const
+    {
+        std::unique_ptr<BasicVectorX> result(new BasicVectorX());
+        cwiseApply(*this, v, result->v, f);
+        return result.release();
+    }
+    template<typename F>
+    void cwiseMapBang(F f)
+    {
+        checkWritable();
+        cwiseApply(*this, v, v, f);
+    }
+    template<typename F>
+    BasicVectorX* cwiseBinary(Object other, F f) const
+    {
+        CwiseOperand<BasicVectorX> operand(other, v, &BasicVectorX::v);
+        std::unique_ptr<BasicVectorX> result(new BasicVectorX());
+        operand.visit([&](auto const& b) {
+            cwiseApply(*this, v, result->v, [&](auto const& a) { return f(a, b); });
+        });
+        return result.release();
+    }
+    template<typename F>
+    void cwiseBinaryBang(Object other, F f)
+    {
+        checkWritable();
+        CwiseOperand<BasicVectorX> operand(other, v, &BasicVectorX::v);
+        operand.visit([&](auto const& b) {
+            cwiseApply(*this, v, v, [&](auto const& a) { return f(a, b); });
+        });
+    }
+
+    BasicVectorX* cwiseAbs() const { return cwiseMap([](auto const& a) { return a.abs(); }); }
+    BasicVectorX* cwiseSqrt() const { return cwiseMap([](auto const& a) { return a.sqrt(); }); }
+    BasicVectorX* cwiseExp() const { return cwiseMap([](auto const& a) { return a.exp(); }); }
+    BasicVectorX* cwiseLog() const { return cwiseMap([](auto const& a) { return a.log(); }); }
+    BasicVectorX* cwiseSquare() const { return cwiseMap([](auto const& a) { return a.square(); }); }
+    BasicVectorX* cwiseInverse() const { return cwiseMap([](auto const& a) { return a.inverse(); }); }
+    void cwiseAbsBang() { cwiseMapBang([](auto const& a) { return a.abs(); }); }
+    void cwiseSqrtBang() { cwiseMapBang([](auto const& a) { return a.sqrt(); }); }
+    void cwiseExpBang() { cwiseMapBang([](auto const& a) { return a.exp(); }); }
+    void cwiseLogBang() { cwiseMapBang([](auto const& a) { return a.log(); }); }
+    void cwiseSquareBang() { cwiseMapBang([](auto const& a) { return a.square(); }); }
+    void cwiseInverseBang() { cwiseMapBang([](auto const& a) { return a.inverse(); }); }
+
+    BasicVectorX* cwiseProduct(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a * b; }); }
+    BasicVectorX* cwiseQuotient(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a / b; }); }
+    BasicVectorX* cwiseMin(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a.min(b); }); }
+    BasicVectorX* cwiseMax(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a.max(b); }); }
+    void cwiseProductBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a * b; }); }
+    void cwiseQuotientBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a / b; }); }
+    void cwiseMinBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a.min(b); }); }
+    void cwiseMaxBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a.max(b); }); }
+
+    BasicVectorX* cwiseClamp(double min, double max) const
+    {
+        checkClampBounds(min, max);
+        return cwiseMap([=](auto const& a) {
+            return a.max(static_cast<Scalar>(min)).min(static_cast<Scalar>(max));
+        });
+    }
+    void cwiseClampBang(double min, double max)
+    {
+        checkClampBounds(min, max);
+        cwiseMapBang([=](auto const& a) {
+            return a.max(static_cast<Scalar>(min)).min(static_cast<Scalar>(max));
+        });
+    }
+
+    /* Picks the coefficient of then_value where self is non-zero, of
+     * else_value otherwise */
+    BasicVectorX* cwiseSelect(Object then_value, Object else_value) const
+    {
+        CwiseOperand<BasicVectorX> then_operand(then_value, v, &BasicVectorX::v);
+        CwiseOperand<BasicVectorX> else_operand(else_value, v, &BasicVectorX::v);
+        std::unique_ptr<BasicVectorX> result(new BasicVectorX());
+        then_operand.visit([&](auto const& then_array) {
+            else_operand.visit([&](auto const& else_array) {
+                cwiseApply(*this, v, result->v, [&](auto const& mask) {
+                    return (mask != static_cast<Scalar>(0)).select(then_array, else_array);
+                });
+            });
+        });
+        return result.release();
+    }
+
+    bool operator ==(BasicVectorX const& other) const
+    { return v == other.v; }
+
+    bool isApprox(BasicVectorX const& other, double tolerance)
+    { return v.isApprox(other.v, tolerance); }
+
+    typedef BasicVectorX<typename OtherPrecision<Scalar>::type> Converted;
+    Converted* convert() const
+    {
+        std::unique_ptr<Converted> result(new Converted());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(v.size(), [&]() {
+            result->v = v.template cast<typename OtherPrecision<Scalar>::type>();
+        });
+        return result.release();
+    }
+
+};
+
+typedef BasicVectorX<double> VectorX;
+typedef BasicVectorX<float> VectorXf;
+
+/*
+ * Document-class: Eigen::VectorXf
+ *
+ * Single-precision version of {Eigen::VectorX}, with the same API.
+ *
+ * @!method to_double
+ *   Converts to double precision
+ *   @return [VectorX]
+ */
+typedef BasicMatrixX<double> MatrixX;
+typedef BasicMatrixX<float> MatrixXf;
+
+/*
+ * Document-class: Eigen::Vector3Array
+ *
+ * A list of 3-vectors stored contiguously, as the columns of a 3xN matrix
+ *
+ * @!method initialize(size = 0)
+ *   Creates a new array of zero vectors
+ *   @param [Integer] size
+ * @!method size
+ *   Returns the number of vectors
+ *   @return [Integer]
+ * @!method memsize
+ *   Returns the number of bytes used by the array, including its vectors
+ *   @return [Integer]
+ * @!method resize(new_size)
+ *   Changes the number of vectors, keeping the existing ones. New vectors
+ *   are set to zero.
+ *   @param [Integer] new_size
+ *   @return [void]
+ * @!method [](index)
+ *   Returns a copy of a vector
+ *   @param [Integer] index
+ *   @return [Vector3]
+ * @!method []=(index, v)
+ *   Sets a vector
+ *   @param [Integer] index
+ *   @param [Vector3] v
+ *   @return [void]
+ * @!method +(offset)
+ *   Adds the same vector to all vectors
+ *   @param [Vector3] offset
+ *   @return [Vector3Array]
+ * @!method -(offset)
+ *   Subtracts the same vector to all vectors
+ *   @param [Vector3] offset
+ *   @return [Vector3Array]
+ * @!method *(scalar)
+ *   Multiplies all vectors by a scalar
+ *   @param [Numeric] scalar
+ *   @return [Vector3Array]
+ * @!method add!(offset)
+ *   In-place version of {#+}
+ *   @param [Vector3] offset
+ *   @return [void]
+ * @!method sub!(offset)
+ *   In-place version of {#-}
+ *   @param [Vector3] offset
+ *   @return [void]
+ * @!method scale!(scalar)
+ *   In-place version of {#*}
+ *   @param [Numeric] scalar
+ *   @return [void]
+ * @!method norms
+ *   Returns the norm of each vector
+ *   @return [VectorX]
+ * @!method dot(other)
+ *   Returns the dot product of each vector with the vector of same index in
+ *   other
+ *   @param [Vector3Array] other
+ *   @return [VectorX]
+ * @!method mean
+ *   Returns the centroid of the vectors
+ *   @return [Vector3]
+ *   @raise [ArgumentError] if the array is empty
+ * @!method covariance
+ *   Returns the sample covariance of the vectors
+ *   @return [MatrixX] a 3x3 matrix
+ *   @raise [ArgumentError] if there are less than 2 vectors
+ * @!method principal_components(k = 3)
+ *   Principal component analysis of the vectors, through the
+ *   eigendecomposition of their covariance. The last axis of a neighbourhood
+ *   of points is the normal of their best-fit plane.
+ *   @param [Integer] k the number of components, between 1 and 3
+ *   @return [(MatrixX,VectorX)] the principal axes as the columns of a
+ *     matrix, and the variance along each of them, by decreasing variance
+ *   @raise [ArgumentError] if there are less than 2 vectors
+ * @!method to_binary
+ *   Returns the vectors as a packed binary string, in the format of a 3xN
+ *   {MatrixX}
+ *   @return [String]
+ * @!method from_binary(buffer)
+ *   Resizes self and sets its vectors from a string created by {#to_binary}
+ *   or by {MatrixX#to_binary} on a 3-row matrix
+ *   @param [String] buffer
+ *   @return [void]
+ * @!method from_memory_view(object)
+ *   Resizes self and copies the vectors of an object that exports a Nx3
+ *   memory view of doubles or floats. The array itself exports a Nx3 memory
+ *   view, during which it cannot be modified from Ruby.
+ *   @param [Object] object
+ *   @return [void]
+ * @!method approx?(v, threshold = dummy_precision)
+ *    Verifies that two arrays are within threshold of each other, elementwise
+ *    @param [Vector3Array]
+ *    @return [Boolean]
+ */
+struct Vector3Array : NoGVLUsage, ReportedMemsize
+{
+    Matrix3Xd points;
+
+    Vector3Array(int size)
+    {
+        checkDimensions(3, size);
+        points.setZero(3, size);
+    }
+    Vector3Array(Matrix3Xd const& _points)
+        : points(_points) {}
+
+    int size() const { return points.cols(); }
+
+    size_t payloadSize() const { return points.size() * sizeof(double); }
+    size_t memsize() const { return sizeof(*this) + payloadSize(); }
+    void reportMemsize() const { updateReportedMemsize(payloadSize()); }
+
+    void resize(int size)
+    {
+        checkDimensions(3, size);
+        checkWritable();
+        int old_size = points.cols();
+        points.conservativeResize(Eigen::NoChange, size);
+        if (size > old_size)
+            points.rightCols(size - old_size).setZero();
+    }
+
+    void checkIndex(int i) const
+    {
+        if (i < 0 || i >= points.cols())
+            throw Exception(rb_eIndexError, "index %i out of bounds (size %li)",
+                    i, static_cast<long>(points.cols()));
+    }
+    Vector3* get(int i) const
+    {
+        checkIndex(i);
+        checkReadable();
+        return new Vector3(points.col(i));
+    }
+    void set(int i, Vector3 const& v)
+    {
+        checkIndex(i);
+        checkWritable();
+        points.col(i) = v.v;
+    }
+
+    Vector3Array* operator + (Vector3 const& offset) const
+    { return new Vector3Array(points.colwise() + offset.v); }
+    Vector3Array* operator - (Vector3 const& offset) const
+    { return new Vector3Array(points.colwise() - offset.v); }
+    Vector3Array* scale(double value) const
+    { return new Vector3Array(points * value); }
+
+    void addBang(Vector3 const& offset) { checkWritable(); points.colwise() += offset.v; }
+    void subBang(Vector3 const& offset) { checkWritable(); points.colwise() -= offset.v; }
+    void scaleBang(double value) { checkWritable(); points *= value; }
+
+    VectorX* norms() const
+    { return new VectorX(points.colwise().norm().transpose()); }
+
+    Vector3* mean() const
+    {
+        checkNotEmpty(points, "mean");
+        return new Vector3(points.rowwise().mean());
+    }
+    MatrixX* covariance() const;
+    Array principalComponents(int k) const;
+    VectorX* dot(Vector3Array const& other) const
+    {
+        checkSameSize(points, other.points);
+        return new VectorX(points.cwiseProduct(other.points).colwise().sum().transpose());
+    }
+
+    String toBinary() const { checkReadable(); return ::toBinary(points.data(), 3, points.cols()); }
+    void fromBinary(String buffer)
+    {
+        checkWritable();
+        long rows, cols;
+        bool swap;
+        char const* data = readBinaryHeader(buffer, rows, cols, swap);
+        if (rows != 3)
+            throw Exception(rb_eArgError, "expected a binary buffer with 3 rows, got %li", rows);
+        points.resize(3, cols);
+        copyBinary(points.data(), data, points.size(), swap);
+    }
+
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+    void fromMemoryView(Object object)
+    {
+        checkWritable();
+        MemoryViewReader reader(object);
+        if (reader.cols() != 3)
+            throw Exception(rb_eArgError, "expected a Nx3 memory view, got %lix%li",
+                    reader.rows(), reader.cols());
+        points.resize(3, reader.rows());
+        Eigen::Transpose<Matrix3Xd> out(points);
+        reader.copyTo(out);
+    }
+#endif
 
-    bool operator ==(VectorX const& other) const
-    { return (*this->v) == (*other.v); }
+    bool operator ==(Vector3Array const& other) const
+    { return points.cols() == other.points.cols() && points == other.points; }
 
-    bool isApprox(VectorX const& other, double tolerance)
-    { return v->isApprox(*other.v, tolerance); }
+    bool isApprox(Vector3Array const& other, double tolerance)
+    { return points.cols() == other.points.cols() && points.isApprox(other.points, tolerance); }
 
+    /* Sets out to the transformation of the points in self */
+    template<typename Transform>
+    void transform(Transform const& t, Vector3Array& out) const
+    {
+        out.checkWritable();
+        Eigen::Matrix3d linear = t.linear();
+        Eigen::Vector3d translation = t.translation();
+        Matrix3Xd const& in = points;
+        Matrix3Xd& result = out.points;
+        result.resize(3, in.cols());
+        parallelFor(in.cols(), [&](long begin, long end) {
+            transformPoints(linear, translation, in, result, begin, end);
+        });
+    }
 };
 
 /* 
@@ -285,6 +1758,18 @@ struct VectorX {
  *    @param [Integer] col the element's column
  *    @param [Numeric] value the new value
  *    @return [Numeric] the value
+ * @!method from_a(array, column_major = true)
+ *    Sets the matrix from a flat array
+ *    @param [Array<Numeric>] array the values. It must be of size at most 16.
+ *      If smaller than 16, the rest is filled with zeroes
+ *    @param [Boolean] column_major whether the values of a column are
+ *      adjacent in the array (true) or the values of a row (false)
+ *    @return [void]
+ * @!method to_a(column_major = true)
+ *    Returns the values flattened in a ruby array
+ *    @param [Boolean] column_major if true, the values of a column will be
+ *      adjacent in the resulting array, if not the values of a row will
+ *    @return [Array<Float>]
  * @!method +(m)
  *    Sums two matrices
  *    @param [Matrix4] m the matrix to add
@@ -304,6 +1789,23 @@ struct VectorX {
  * @!method -@(v)
  *    Returns this matrix' negation
  *    @return [Matrix4] the result
+ * @!method add!(m)
+ *    In-place sum
+ *    @param [Matrix4] m
+ *    @return [void]
+ * @!method sub!(m)
+ *    In-place subtraction
+ *    @param [Matrix4] m
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
+ * @!method mul_into!(a, b)
+ *    Sets self to the matrix product a * b
+ *    @param [Matrix4] a
+ *    @param [Matrix4] b
+ *    @return [void]
  * @!method T
  *    Returns the transposed matrix
  *    @return [Matrix4]
@@ -318,220 +1820,2704 @@ struct VectorX {
  *    Verifies that two matrices are within threshold of each other, elementwise
  *    @param [Matrix4]
  *    @return [Boolean]
+ * @!method to_binary
+ *   Returns the coefficients as a packed binary string
+ *   @return [String]
+ * @!method from_binary(buffer)
+ *   Sets the coefficients from a string created by {#to_binary}
+ *   @param [String] buffer
+ *   @return [void]
  */
 struct Matrix4
 {
-    Matrix4d* mx;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-    Matrix4() : mx(new Matrix4d()) {}
+    Matrix4d mx;
+
+    Matrix4() {}
 
     Matrix4(Matrix4d const& _mx)
-        : mx(new Matrix4d(_mx)) {}
+        : mx(_mx) {}
+
+    double norm() const { return mx.norm(); }
 
-    ~Matrix4()
-    { delete mx; }
+    int rows() const { return mx.rows(); }
+    int cols() const { return mx.cols(); }
+    int size() const { return mx.size(); }
 
-    double norm() const { return mx->norm(); }
+    double get(int i, int j ) const { return mx(i,j); }
+    void set(int i, int j, double value) { mx(i,j) = value; }
 
-    int rows() const { return mx->rows(); }
-    int cols() const { return mx->cols(); }
-    int size() const { return mx->size(); }
+    void fromArray(Array array, bool column_major)
+    { fillFromArray(mx, array, column_major, true); }
+    Array toArray(bool column_major) const
+    { return ::toArray(mx, column_major); }
 
-    double get(int i, int j ) const { return (*mx)(i,j); }
-    void set(int i, int j, double value) { (*mx)(i,j) = value; }
+    String toBinary() const { return ::toBinary(mx.data(), 4, 4); }
+    void fromBinary(String buffer) { ::fromBinary(buffer, mx.data(), 4, 4); }
 
     Matrix4* transpose() const
-    { return new Matrix4(mx->transpose()); }
+    { return new Matrix4(mx.transpose()); }
 
     Matrix4* operator + (Matrix4 const& other) const
-    { return new Matrix4(*mx + *other.mx); }
+    { return new Matrix4(mx + other.mx); }
 
     Matrix4* operator - (Matrix4 const& other) const
-    { return new Matrix4(*mx - *other.mx); }
+    { return new Matrix4(mx - other.mx); }
 
     Matrix4* operator / (double scalar) const
-    { return new Matrix4(*mx / scalar); }
+    { return new Matrix4(mx / scalar); }
 
     Matrix4* negate() const
-    { return new Matrix4(-*mx); }
+    { return new Matrix4(-mx); }
+
+    Matrix4* scale(double value) const
+    { return new Matrix4(mx * value); }
+
+    void addBang(Matrix4 const& other) { mx += other.mx; }
+    void subBang(Matrix4 const& other) { mx -= other.mx; }
+    void scaleBang(double value) { mx *= value; }
+    void mulInto(Matrix4 const& a, Matrix4 const& b) { mx = a.mx * b.mx; }
+
+    Matrix4* dotM (Matrix4 const& other) const
+    { return new Matrix4(mx * other.mx); }
+
+    bool operator ==(Matrix4 const& other) const
+    { return mx == other.mx; }
+
+    bool isApprox(Matrix4 const& other, double tolerance)
+    { return mx.isApprox(other.mx, tolerance); }
+};
+
+template<typename Solver> struct SVD;
+typedef SVD< Eigen::JacobiSVD<Eigen::MatrixXd> > JacobiSVD;
+typedef SVD< Eigen::BDCSVD<Eigen::MatrixXd> > BDCSVD;
+
+template<typename Decomposition> struct Factorization;
+typedef Factorization< Eigen::LLT<Eigen::MatrixXd> > LLT;
+typedef Factorization< Eigen::LDLT<Eigen::MatrixXd> > LDLT;
+typedef Factorization< Eigen::PartialPivLU<Eigen::MatrixXd> > PartialPivLU;
+typedef Factorization< Eigen::ColPivHouseholderQR<Eigen::MatrixXd> > ColPivHouseholderQR;
+
+/* 
+ * Document-class: Eigen::MatrixX
+ *
+ * A variable-size matrix holding floating-point numbers
+ *
+ * The products and decompositions release the GVL when their operands are
+ * large enough, so that other Ruby threads can run meanwhile. Matrices and
+ * vectors used by such a computation cannot be modified until it finishes,
+ * attempts raise RuntimeError.
+ *
+ * @!method resize(rows, cols)
+ *    Resizes the matrix
+ *    @param [Integer] rows the new number of rows
+ *    @param [Integer] cols the new number of columns
+ * @!method rows
+ *    @return [Integer] the number of rows
+ * @!method cols
+ *    @return [Numeric] the number of columns
+ * @!method size
+ *    @return [Numeric] the number of elements
+ * @!method memsize
+ *    @return [Integer] the number of bytes used by the matrix, including its
+ *      coefficients
+ * @!method [](row, col)
+ *    Accesses an element
+ *    @param [Integer] row the element's row
+ *    @param [Integer] col the element's column
+ *    @return [Numeric] the required element
+ * @!method []=(row, col, value)
+ *    Sets an element
+ *    @param [Integer] row the element's row
+ *    @param [Integer] col the element's column
+ *    @param [Numeric] value the new value
+ *    @return [Numeric] the value
+ * @!method from_a(array, rows = -1, cols = -1, column_major = true)
+ *    Resizes the matrix and sets it from a flat array
+ *
+ *    If both rows and cols are -1, the matrix keeps its current size. If only
+ *    one of them is -1, it is computed from the array size. If the array is
+ *    smaller than the matrix, the remaining elements are set to zero.
+ *
+ *    @param [Array<Numeric>] array the values
+ *    @param [Integer] rows the new number of rows
+ *    @param [Integer] cols the new number of columns
+ *    @param [Boolean] column_major whether the values of a column are
+ *      adjacent in the array (true) or the values of a row (false)
+ *    @return [void]
+ * @!method to_a(column_major = true)
+ *    Returns the values flattened in a ruby array
+ *    @param [Boolean] column_major if true, the values of a column will be
+ *      adjacent in the resulting array, if not the values of a row will
+ *    @return [Array<Float>]
+ * @!method block(row, col, rows, cols)
+ *    Returns a view of a block of this matrix, without copying it. Writes
+ *    to the view modify self
+ *    @param [Integer] row the block's first row
+ *    @param [Integer] col the block's first column
+ *    @param [Integer] rows the number of rows
+ *    @param [Integer] cols the number of columns
+ *    @return [MatrixXView]
+ * @!method row_view(row)
+ *    Returns a view of a row. Unlike {#row}, it does not copy it
+ *    @param [Integer] row
+ *    @return [MatrixXView] a 1xN view
+ * @!method col_view(col)
+ *    Returns a view of a column. Unlike {#col}, it does not copy it
+ *    @param [Integer] col
+ *    @return [MatrixXView] a Nx1 view
+ * @!method setRow(row, vector)
+ *    Sets a whole matrix row
+ *    @param [Integer] row the row index
+ *    @param [VectorX] vector the row values
+ * @!method setColumn(column, vector)
+ *    Sets a whole matrix column
+ *    @param [Integer] row the column index
+ *    @param [VectorX] vector the column values
+ * @!method +(m)
+ *    Sums two matrices
+ *    @param [MatrixX] m the matrix to add
+ *    @return [MatrixX] the sum
+ * @!method -(m)
+ *    Subtracts two matrices
+ *    @param [MatrixX] m the matrix to subtract to self
+ *    @return [MatrixX] the subtraction
+ * @!method *(v)
+ *    Multiplies by a scalar
+ *    @param [Numeric] v the scalar
+ *    @return [MatrixX] the result
+ * @!method /(v)
+ *    Divides this matrix by a scalar
+ *    @param [Numeric] v the scalar
+ *    @return [MatrixX] the result
+ * @!method -@(v)
+ *    Returns this matrix' negation
+ *    @return [MatrixX] the result
+ * @!method add!(m)
+ *    In-place sum
+ *    @param [MatrixX] m
+ *    @return [void]
+ * @!method sub!(m)
+ *    In-place subtraction
+ *    @param [MatrixX] m
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
+ * @!method mul_into!(a, b, alpha = 1, beta = 0)
+ *    Sets self to alpha * a * b + beta * self (GEMM), without allocating if
+ *    self already has the right size
+ *    @param [MatrixX] a
+ *    @param [MatrixX] b
+ *    @param [Numeric] alpha
+ *    @param [Numeric] beta
+ *    @return [void]
+ * @!method T
+ *    Returns the transposed matrix
+ *    @return [MatrixX]
+ * @!method norm
+ *    Returns the matrix' norm
+ *    @return [Numeric]
+ * @!method dotV(m)
+ *    Matrix/vector multiplication
+ *    @param [VectorX]
+ *    @return [Numeric]
+ * @!method dotM(m)
+ *    Matrix multiplication
+ *    @param [Matrix4]
+ *    @return [Numeric]
+ * @!method sum
+ *    Sum of the coefficients
+ *    @return [Float]
+ * @!method mean
+ *    Mean of the coefficients
+ *    @return [Float]
+ *    @raise [ArgumentError] if the matrix is empty
+ * @!method min
+ *    Smallest coefficient
+ *    @return [Float]
+ *    @raise [ArgumentError] if the matrix is empty
+ * @!method max
+ *    Largest coefficient
+ *    @return [Float]
+ *    @raise [ArgumentError] if the matrix is empty
+ * @!method argmin
+ *    Position of the smallest coefficient
+ *    @return [Array(Integer,Integer)] its row and column
+ *    @raise [ArgumentError] if the matrix is empty
+ * @!method argmax
+ *    Position of the largest coefficient
+ *    @return [Array(Integer,Integer)] its row and column
+ *    @raise [ArgumentError] if the matrix is empty
+ * @!method squared_norm
+ *    Squared Frobenius norm
+ *    @return [Float]
+ * @!method lp_norm(p)
+ *    Lp norm of the coefficients, seen as a single vector
+ *    @param [Float] p the exponent, greater or equal to 1. Pass
+ *      Float::INFINITY for the largest absolute value
+ *    @return [Float]
+ * @!method trace
+ *    Sum of the diagonal coefficients
+ *    @return [Float]
+ * @!method colwise_sum
+ *    Per-column sums, see also {#colwise_mean}, {#colwise_min},
+ *    {#colwise_max} and {#colwise_norm}
+ *    @return [VectorX] one coefficient per column
+ * @!method rowwise_sum
+ *    Per-row sums, see also {#rowwise_mean}, {#rowwise_min},
+ *    {#rowwise_max} and {#rowwise_norm}
+ *    @return [VectorX] one coefficient per row
+ * @!method cwise_abs
+ *    Coefficient-wise absolute value. {#cwise_sqrt}, {#cwise_exp},
+ *    {#cwise_log}, {#cwise_square} and {#cwise_inverse} (1/x) are the
+ *    other coefficient-wise functions. Each has an in-place variant, e.g.
+ *    {#cwise_abs!}
+ *    @return [MatrixX]
+ * @!method cwise_product(other)
+ *    Coefficient-wise product. {#cwise_quotient}, {#cwise_min} and
+ *    {#cwise_max} are the other coefficient-wise binary operations. Each
+ *    has an in-place variant, e.g. {#cwise_product!}
+ *    @param [MatrixX,Numeric] other a matrix of the same size, or a scalar
+ *      applied to all coefficients
+ *    @return [MatrixX]
+ * @!method cwise_clamp(min, max)
+ *    Clamps each coefficient to [min, max], see also {#cwise_clamp!}
+ *    @param [Numeric] min
+ *    @param [Numeric] max
+ *    @return [MatrixX]
+ * @!method cwise_select(then_value, else_value)
+ *    Takes the coefficients of then_value where self is non-zero, of
+ *    else_value elsewhere
+ *    @param [MatrixX,Numeric] then_value
+ *    @param [MatrixX,Numeric] else_value
+ *    @return [MatrixX]
+ * @!method set_zero(rows, cols)
+ *    Resizes the matrix and sets all its coefficients to zero
+ *    @param [Integer] rows
+ *    @param [Integer] cols
+ *    @return [void]
+ * @!method set_identity(rows, cols)
+ *    Resizes the matrix and sets it to the identity, i.e. ones on the
+ *    diagonal and zeros elsewhere
+ *    @param [Integer] rows
+ *    @param [Integer] cols
+ *    @return [void]
+ * @!method set_constant(rows, cols, value)
+ *    Resizes the matrix and sets all its coefficients to value
+ *    @param [Integer] rows
+ *    @param [Integer] cols
+ *    @param [Numeric] value
+ *    @return [void]
+ * @!method set_random(rows, cols)
+ *    Resizes the matrix and sets its coefficients to random values in
+ *    [-1, 1]. They come from the C library's rand(), which Kernel#srand
+ *    does not seed
+ *    @param [Integer] rows
+ *    @param [Integer] cols
+ *    @return [void]
+ * @!method approx?(m, threshold = dummy_precision)
+ *    Verifies that two matrices are within threshold of each other, elementwise
+ *    @param [Matrix4]
+ *    @return [Boolean]
+ * @!method jacobiSvd(flags = 0)
+ *    Returns a SVD solver to find V from W in self.dotV(V) = W
+ *    @param [Integer] flags solver flags, as OR-ed values of Eigen::ComputeFullU,
+ *      Eigen::ComputeThinU and Eigen::ComputeThinV. See Eigen documentation
+ *    @return [JacobiSVD]
+ * @!method bdcSvd(flags = 0)
+ *    Returns a divide-and-conquer SVD, which is much faster than
+ *    {#jacobiSvd} on large matrices
+ *    @param [Integer] flags solver flags, see {#jacobiSvd}
+ *    @return [BDCSVD]
+ * @!method llt
+ *    Returns the Cholesky (LL^T) factorization of this symmetric
+ *    positive-definite matrix
+ *    @return [LLT]
+ * @!method ldlt
+ *    Returns the robust Cholesky (LDL^T) factorization of this symmetric
+ *    positive or negative semi-definite matrix
+ *    @return [LDLT]
+ * @!method lu
+ *    Returns the LU factorization with partial pivoting of this invertible
+ *    matrix
+ *    @return [PartialPivLU]
+ * @!method qr
+ *    Returns the Householder QR factorization with column pivoting of this
+ *    matrix
+ *    @return [ColPivHouseholderQR]
+ * @!method to_binary
+ *    Returns the size and coefficients as a packed binary string
+ *    @return [String]
+ * @!method from_binary(buffer)
+ *    Resizes self and sets its coefficients from a string created by
+ *    {#to_binary}
+ *    @param [String] buffer
+ *    @return [void]
+ * @!method from_memory_view(object)
+ *    Resizes self and copies the coefficients of an object that exports a
+ *    two-dimensional memory view of doubles or floats. A one-dimensional
+ *    view is copied as a column. The matrix itself exports a column-major
+ *    memory view of its coefficients, during which it cannot be modified
+ *    from Ruby.
+ *    @param [Object] object
+ *    @return [void]
+ * @!method to_single
+ *   Converts to single precision
+ *   @return [MatrixXf]
+ */
+template<typename Scalar>
+struct BasicMatrixX : NoGVLUsage, ReportedMemsize {
+
+    typedef EigenMatrixX<Scalar> EigenType;
+    EigenType m;
+
+    BasicMatrixX() {}
+    BasicMatrixX(const BasicMatrixX& m) : m(m.m) {}
+    BasicMatrixX(int rows, int cols) : m(rows,cols) {}
+    BasicMatrixX(const EigenType& _m) : m(_m) {}
+
+    void resize(int rows, int cols) { checkWritable(); m.resize(rows,cols); }
+    void conservativeResize(int rows, int cols) { checkWritable(); m.conservativeResize(rows,cols); }
+
+    size_t payloadSize() const { return m.size() * sizeof(Scalar); }
+    size_t memsize() const { return sizeof(*this) + payloadSize(); }
+    void reportMemsize() const { updateReportedMemsize(payloadSize()); }
+
+    double norm() const { return m.norm(); }
+
+    unsigned int rows() const { return m.rows(); }
+    unsigned int cols() const { return m.cols(); }
+    unsigned int size() const { return m.size(); }
+
+    double get(int i, int j ) const { checkReadable(); return m(i,j); }
+    void set(int i, int j, double value) { checkWritable(); m(i,j) = value; }
+
+    void fromArray(Array array, int nrows, int ncols, bool column_major)
+    {
+        checkWritable();
+        if (nrows == -1 && ncols == -1)
+        {
+            nrows = m.rows();
+            ncols = m.cols();
+        }
+        else if (nrows == -1)
+        {
+            if (ncols <= 0)
+                throw Exception(rb_eArgError, "cannot infer the row count with %i columns", ncols);
+            nrows = array.size() / ncols;
+        }
+        else if (ncols == -1)
+        {
+            if (nrows <= 0)
+                throw Exception(rb_eArgError, "cannot infer the column count with %i rows", nrows);
+            ncols = array.size() / nrows;
+        }
+
+        m.resize(nrows, ncols);
+        fillFromArray(m, array, column_major, true);
+    }
+    Array toArray(bool column_major) const
+    { checkReadable(); return ::toArray(m, column_major); }
+
+    String toBinary() const { checkReadable(); return ::toBinary(m.data(), m.rows(), m.cols()); }
+    void fromBinary(String buffer)
+    {
+        checkWritable();
+        long rows, cols;
+        bool swap;
+        char const* data = readBinaryHeader<Scalar>(buffer, rows, cols, swap);
+        m.resize(rows, cols);
+        copyBinary(m.data(), data, m.size(), swap);
+    }
+
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+    void fromMemoryView(Object object)
+    {
+        checkWritable();
+        MemoryViewReader reader(object);
+        m.resize(reader.rows(), reader.cols());
+        reader.copyTo(m);
+    }
+#endif
+    
+    BasicVectorX<Scalar>* getRow(int i) const { return new BasicVectorX<Scalar>(m.row(i)); }
+    void setRow(int i, const BasicVectorX<Scalar>& v) { checkWritable(); m.row(i) = v.v; }
+
+    BasicVectorX<Scalar>* getColumn(int j) const { return new BasicVectorX<Scalar>(m.col(j)); }
+    void setColumn(int j, const BasicVectorX<Scalar>& v) { checkWritable(); m.col(j) = v.v; }
+
+    BasicMatrixX* transpose() const
+    { return new BasicMatrixX(m.transpose()); }
+
+    BasicMatrixX* operator + (BasicMatrixX const& other) const
+    { return new BasicMatrixX(m + other.m); }
+
+    BasicMatrixX* operator - (BasicMatrixX const& other) const
+    { return new BasicMatrixX(m - other.m); }
+
+    BasicMatrixX* operator / (double scalar) const
+    { return new BasicMatrixX(m / scalar); }
+
+    BasicMatrixX* negate() const
+    { return new BasicMatrixX(-m); }
+    
+    BasicMatrixX* scale (double scalar) const
+    { return new BasicMatrixX(m * scalar); }
+
+    void addBang(BasicMatrixX const& other)
+    {
+        checkWritable();
+        checkSameSize(m, other.m);
+        m += other.m;
+    }
+    void subBang(BasicMatrixX const& other)
+    {
+        checkWritable();
+        checkSameSize(m, other.m);
+        m -= other.m;
+    }
+    void scaleBang(double scalar) { checkWritable(); m *= scalar; }
+
+    void mulInto(BasicMatrixX const& a, BasicMatrixX const& b, double alpha, double beta)
+    {
+        checkWritable();
+        if (a.m.cols() != b.m.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a %lix%li matrix",
+                    static_cast<long>(a.m.rows()), static_cast<long>(a.m.cols()),
+                    static_cast<long>(b.m.rows()), static_cast<long>(b.m.cols()));
+
+        // When self is an operand, it must not be resized before the product
+        bool aliased = (&a == this || &b == this);
+        if (beta == 0)
+        {
+            if (!aliased)
+                m.resize(a.m.rows(), b.m.cols());
+        }
+        else if (m.rows() != a.m.rows() || m.cols() != b.m.cols())
+            throw Exception(rb_eArgError, "expected self to be a %lix%li matrix, got %lix%li",
+                    static_cast<long>(a.m.rows()), static_cast<long>(b.m.cols()),
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()));
+
+        // The aliased product is swapped into self once the GVL is back, as
+        // other threads may be reading self meanwhile
+        EigenType result;
+        if (aliased)
+            result.resize(a.m.rows(), b.m.cols());
+
+        NoGVLGuard guard_a(a), guard_b(b), guard_self(*this, !aliased);
+        computeWithoutGVL(a.m.rows() * a.m.cols() * b.m.cols(), [&]() {
+            if (aliased)
+            {
+                result.noalias() = alpha * a.m * b.m;
+                if (beta != 0)
+                    result += beta * m;
+            }
+            else if (beta == 0)
+                m.noalias() = alpha * a.m * b.m;
+            else
+            {
+                m *= beta;
+                m.noalias() += alpha * a.m * b.m;
+            }
+        });
+        if (aliased)
+            m.swap(result);
+    }
+
+    void assignLinearCombination(Array coefficients, Array operands)
+    { assignLinear(*this, &BasicMatrixX::m, coefficients, operands); }
+
+    BasicVectorX<Scalar>* dotV (BasicVectorX<Scalar> const& other) const
+    {
+        if (m.cols() != other.v.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a vector of size %li",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.v.rows()));
+
+        std::unique_ptr<BasicVectorX<Scalar>> result(new BasicVectorX<Scalar>(m.rows()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.rows() * m.cols(), [&]() { result->v.noalias() = m * other.v; });
+        return result.release();
+    }
+    
+    BasicMatrixX* dotM (BasicMatrixX const& other) const
+    {
+        if (m.cols() != other.m.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a %lix%li matrix",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.m.rows()), static_cast<long>(other.m.cols()));
+
+        std::unique_ptr<BasicMatrixX> result(new BasicMatrixX(m.rows(), other.m.cols()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.rows() * m.cols() * other.m.cols(),
+                [&]() { result->m.noalias() = m * other.m; });
+        return result.release();
+    }
+
+    double sum() const
+    { return reduceWithoutGVL(*this, m.size(), [&]() { return m.sum(); }); }
+    double mean() const
+    {
+        checkNotEmpty(m, "mean");
+        return reduceWithoutGVL(*this, m.size(), [&]() { return m.mean(); });
+    }
+    double minCoeff() const
+    {
+        checkNotEmpty(m, "minimum");
+        return reduceWithoutGVL(*this, m.size(), [&]() { return m.minCoeff(); });
+    }
+    double maxCoeff() const
+    {
+        checkNotEmpty(m, "maximum");
+        return reduceWithoutGVL(*this, m.size(), [&]() { return m.maxCoeff(); });
+    }
+    Array argmin() const
+    {
+        checkNotEmpty(m, "minimum");
+        Eigen::Index row, col;
+        reduceWithoutGVL(*this, m.size(), [&]() { return m.minCoeff(&row, &col); });
+        return rowCol(row, col);
+    }
+    Array argmax() const
+    {
+        checkNotEmpty(m, "maximum");
+        Eigen::Index row, col;
+        reduceWithoutGVL(*this, m.size(), [&]() { return m.maxCoeff(&row, &col); });
+        return rowCol(row, col);
+    }
+    static Array rowCol(long row, long col)
+    {
+        Array result;
+        result.push(Object(LONG2NUM(row)));
+        result.push(Object(LONG2NUM(col)));
+        return result;
+    }
+    double squaredNorm() const
+    { return reduceWithoutGVL(*this, m.size(), [&]() { return m.squaredNorm(); }); }
+    double lpNorm(double p) const
+    {
+        checkNormExponent(p);
+        return reduceWithoutGVL(*this, m.size(), [&]() { return ::lpNorm(m, p); });
+    }
+    double trace() const
+    { return m.trace(); }
+
+    void setZero(int rows, int cols)
+    { checkDimensions(rows, cols); checkWritable(); m.setZero(rows, cols); }
+    void setIdentity(int rows, int cols)
+    { checkDimensions(rows, cols); checkWritable(); m.setIdentity(rows, cols); }
+    void setConstant(int rows, int cols, double value)
+    { checkDimensions(rows, cols); checkWritable(); m.setConstant(rows, cols, value); }
+    void setRandom(int rows, int cols)
+    { checkDimensions(rows, cols); checkWritable(); m.setRandom(rows, cols); }
+
+    /* Sets self to the concatenation of blocks, side by side if horizontal,
+     * on top of each other otherwise. Blocks are matrices or vectors, the
+     * latter seen as single columns. Self may be one of the blocks */
+    void assignStack(Array blocks, bool horizontal)
+    {
+        typedef Eigen::Map<EigenType const> BlockMap;
+        checkWritable();
+
+        long count = blocks.size();
+        std::vector<BlockMap> maps;
+        std::vector<std::unique_ptr<NoGVLGuard> > guards;
+        maps.reserve(count);
+        long rows = 0, cols = 0;
+        for (long i = 0; i < count; ++i)
+        {
+            VALUE block = RARRAY_AREF(blocks.value(), i);
+            if (rb_obj_is_kind_of(block, Data_Type<BasicMatrixX>::klass()))
+            {
+                BasicMatrixX const* matrix = Data_Type<BasicMatrixX>::from_ruby(block);
+                maps.emplace_back(matrix->m.data(), matrix->m.rows(), matrix->m.cols());
+                guards.emplace_back(new NoGVLGuard(*matrix));
+            }
+            else
+            {
+                BasicVectorX<Scalar> const* vector = Data_Type< BasicVectorX<Scalar> >::from_ruby(block);
+                maps.emplace_back(vector->v.data(), vector->v.size(), 1);
+                guards.emplace_back(new NoGVLGuard(*vector));
+            }
+
+            BlockMap const& map = maps.back();
+            if (i == 0)
+            {
+                rows = map.rows();
+                cols = map.cols();
+            }
+            else if (horizontal)
+            {
+                if (map.rows() != rows)
+                    throw Exception(rb_eArgError, "block %li has %li rows, expected %li",
+                            i, static_cast<long>(map.rows()), rows);
+                cols += map.cols();
+            }
+            else
+            {
+                if (map.cols() != cols)
+                    throw Exception(rb_eArgError, "block %li has %li columns, expected %li",
+                            i, static_cast<long>(map.cols()), cols);
+                rows += map.rows();
+            }
+        }
+
+        EigenType result(rows, cols);
+        computeWithoutGVL(rows * cols, [&]() {
+            long offset = 0;
+            for (BlockMap const& map : maps)
+            {
+                if (horizontal)
+                {
+                    result.middleCols(offset, map.cols()) = map;
+                    offset += map.cols();
+                }
+                else
+                {
+                    result.middleRows(offset, map.rows()) = map;
+                    offset += map.rows();
+                }
+            }
+        });
+        m.swap(result);
+    }
+
+    /* Coefficient-wise operations, through Eigen's array API */
+    template<typename F>
+    BasicMatrixX* cwiseMap(F f) const
+    {
+        std::unique_ptr<BasicMatrixX> result(new BasicMatrixX());
+        cwiseApply(*this, m, result->m, f);
+        return result.release();
+    }
+    template<typename F>
+    void cwiseMapBang(F f)
+    {
+        checkWritable();
+        cwiseApply(*this, m, m, f);
+    }
+    template<typename F>
+    BasicMatrixX* cwiseBinary(Object other, F f) const
+    {
+        CwiseOperand<BasicMatrixX> operand(other, m, &BasicMatrixX::m);
+        std::unique_ptr<BasicMatrixX> result(new BasicMatrixX());
+        operand.visit([&](auto const& b) {
+            cwiseApply(*this, m, result->m, [&](auto const& a) { return f(a, b); });
+        });
+        return result.release();
+    }
+    template<typename F>
+    void cwiseBinaryBang(Object other, F f)
+    {
+        checkWritable();
+        CwiseOperand<BasicMatrixX> operand(other, m, &BasicMatrixX::m);
+        operand.visit([&](auto const& b) {
+            cwiseApply(*this, m, m, [&](auto const& a) { return f(a, b); });
+        });
+    }
+
+    BasicMatrixX* cwiseAbs() const { return cwiseMap([](auto const& a) { return a.abs(); }); }
+    BasicMatrixX* cwiseSqrt() const { return cwiseMap([](auto const& a) { return a.sqrt(); }); }
+    BasicMatrixX* cwiseExp() const { return cwiseMap([](auto const& a) { return a.exp(); }); }
+    BasicMatrixX* cwiseLog() const { return cwiseMap([](auto const& a) { return a.log(); }); }
+    BasicMatrixX* cwiseSquare() const { return cwiseMap([](auto const& a) { return a.square(); }); }
+    BasicMatrixX* cwiseInverse() const { return cwiseMap([](auto const& a) { return a.inverse(); }); }
+    void cwiseAbsBang() { cwiseMapBang([](auto const& a) { return a.abs(); }); }
+    void cwiseSqrtBang() { cwiseMapBang([](auto const& a) { return a.sqrt(); }); }
+    void cwiseExpBang() { cwiseMapBang([](auto const& a) { return a.exp(); }); }
+    void cwiseLogBang() { cwiseMapBang([](auto const& a) { return a.log(); }); }
+    void cwiseSquareBang() { cwiseMapBang([](auto const& a) { return a.square(); }); }
+    void cwiseInverseBang() { cwiseMapBang([](auto const& a) { return a.inverse(); }); }
+
+    BasicMatrixX* cwiseProduct(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a * b; }); }
+    BasicMatrixX* cwiseQuotient(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a / b; }); }
+    BasicMatrixX* cwiseMin(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a.min(b); }); }
+    BasicMatrixX* cwiseMax(Object other) const
+    { return cwiseBinary(other, [](auto const& a, auto const& b) { return a.max(b); }); }
+    void cwiseProductBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a * b; }); }
+    void cwiseQuotientBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a / b; }); }
+    void cwiseMinBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a.min(b); }); }
+    void cwiseMaxBang(Object other)
+    { cwiseBinaryBang(other, [](auto const& a, auto const& b) { return a.max(b); }); }
+
+    BasicMatrixX* cwiseClamp(double min, double max) const
+    {
+        checkClampBounds(min, max);
+        return cwiseMap([=](auto const& a) {
+            return a.max(static_cast<Scalar>(min)).min(static_cast<Scalar>(max));
+        });
+    }
+    void cwiseClampBang(double min, double max)
+    {
+        checkClampBounds(min, max);
+        cwiseMapBang([=](auto const& a) {
+            return a.max(static_cast<Scalar>(min)).min(static_cast<Scalar>(max));
+        });
+    }
+
+    /* Picks the coefficient of then_value where self is non-zero, of
+     * else_value otherwise */
+    BasicMatrixX* cwiseSelect(Object then_value, Object else_value) const
+    {
+        CwiseOperand<BasicMatrixX> then_operand(then_value, m, &BasicMatrixX::m);
+        CwiseOperand<BasicMatrixX> else_operand(else_value, m, &BasicMatrixX::m);
+        std::unique_ptr<BasicMatrixX> result(new BasicMatrixX());
+        then_operand.visit([&](auto const& then_array) {
+            else_operand.visit([&](auto const& else_array) {
+                cwiseApply(*this, m, result->m, [&](auto const& mask) {
+                    return (mask != static_cast<Scalar>(0)).select(then_array, else_array);
+                });
+            });
+        });
+        return result.release();
+    }
+
+    /* Computes a per-column or per-row reduction into a new vector */
+    template<typename F>
+    BasicVectorX<Scalar>* partialReduction(F f) const
+    {
+        std::unique_ptr< BasicVectorX<Scalar> > result(new BasicVectorX<Scalar>());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(m.size(), [&]() { f(result->v); });
+        return result.release();
+    }
+
+    BasicVectorX<Scalar>* colwiseSum() const
+    { return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.colwise().sum().transpose(); }); }
+    BasicVectorX<Scalar>* colwiseMean() const
+    {
+        checkNotEmpty(m, "mean");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.colwise().mean().transpose(); });
+    }
+    BasicVectorX<Scalar>* colwiseMin() const
+    {
+        checkNotEmpty(m, "minimum");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.colwise().minCoeff().transpose(); });
+    }
+    BasicVectorX<Scalar>* colwiseMax() const
+    {
+        checkNotEmpty(m, "maximum");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.colwise().maxCoeff().transpose(); });
+    }
+    BasicVectorX<Scalar>* colwiseNorm() const
+    { return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.colwise().norm().transpose(); }); }
+
+    BasicVectorX<Scalar>* rowwiseSum() const
+    { return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.rowwise().sum(); }); }
+    BasicVectorX<Scalar>* rowwiseMean() const
+    {
+        checkNotEmpty(m, "mean");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.rowwise().mean(); });
+    }
+    BasicVectorX<Scalar>* rowwiseMin() const
+    {
+        checkNotEmpty(m, "minimum");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.rowwise().minCoeff(); });
+    }
+    BasicVectorX<Scalar>* rowwiseMax() const
+    {
+        checkNotEmpty(m, "maximum");
+        return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.rowwise().maxCoeff(); });
+    }
+    BasicVectorX<Scalar>* rowwiseNorm() const
+    { return partialReduction([&](EigenVectorX<Scalar>& out) { out = m.rowwise().norm(); }); }
+
+    /* The observations are the rows of m if rowwise is true, its columns
+     * otherwise */
+    BasicMatrixX* covariance(bool rowwise) const
+    {
+        long dim = rowwise ? m.cols() : m.rows();
+        long count = rowwise ? m.rows() : m.cols();
+        checkObservationCount(count);
+        std::unique_ptr<BasicMatrixX> result(new BasicMatrixX(dim, dim));
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(dim * dim * count, [&]() {
+            if (rowwise)
+                computeCovariance(m.transpose(), result->m);
+            else
+                computeCovariance(m, result->m);
+        });
+        return result.release();
+    }
+
+    // Decompositions, only defined in double precision
+    Array principalComponents(int k, bool rowwise) const;
+    JacobiSVD* jacobiSvd(int flags = 0) const;
+    BDCSVD* bdcSvd(int flags = 0) const;
+    LLT* llt() const;
+    LDLT* ldlt() const;
+    PartialPivLU* lu() const;
+    ColPivHouseholderQR* qr() const;
+
+    bool operator ==(BasicMatrixX const& other) const
+    { return m == other.m; }
+
+    bool isApprox(BasicMatrixX const& other, double tolerance)
+    { return m.isApprox(other.m, tolerance); }
+
+    typedef BasicMatrixX<typename OtherPrecision<Scalar>::type> Converted;
+    Converted* convert() const
+    {
+        std::unique_ptr<Converted> result(new Converted());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(m.size(), [&]() {
+            result->m = m.template cast<typename OtherPrecision<Scalar>::type>();
+        });
+        return result.release();
+    }
+};
+
+/*
+ * Document-class: Eigen::MatrixXf
+ *
+ * Single-precision version of {Eigen::MatrixX}, with the same API. The
+ * decompositions (jacobiSvd, llt, ...) are only available in double
+ * precision.
+ *
+ * @!method to_double
+ *   Converts to double precision
+ *   @return [MatrixX]
+ */
+
+template<typename Scalar>
+void BasicVectorX<Scalar>::mulInto(BasicMatrixX<Scalar> const& m, BasicVectorX const& other, double alpha, double beta)
+{
+    checkWritable();
+    if (m.m.cols() != other.v.rows())
+        throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a vector of size %li",
+                static_cast<long>(m.m.rows()), static_cast<long>(m.m.cols()),
+                static_cast<long>(other.v.rows()));
+
+    // When self is the operand, it must not be resized before the product
+    bool aliased = (&other == this);
+    if (beta == 0)
+    {
+        if (!aliased)
+            v.resize(m.m.rows());
+    }
+    else if (v.rows() != m.m.rows())
+        throw Exception(rb_eArgError, "expected self to be of size %li, got %li",
+                static_cast<long>(m.m.rows()), static_cast<long>(v.rows()));
+
+    // The aliased product is swapped into self once the GVL is back, as
+    // other threads may be reading self meanwhile
+    EigenType result;
+    if (aliased)
+        result.resize(m.m.rows());
+
+    NoGVLGuard guard_m(m), guard_other(other), guard_self(*this, !aliased);
+    computeWithoutGVL(m.m.rows() * m.m.cols(), [&]() {
+        if (aliased)
+        {
+            result.noalias() = alpha * m.m * other.v;
+            if (beta != 0)
+                result += beta * v;
+        }
+        else if (beta == 0)
+            v.noalias() = alpha * m.m * other.v;
+        else
+        {
+            v *= beta;
+            v.noalias() += alpha * m.m * other.v;
+        }
+    });
+    if (aliased)
+        v.swap(result);
+}
+
+/* 
+ * Document-class: Eigen::MatrixXView
+ *
+ * A rectangular block of a {Eigen::MatrixX}, which reads and writes
+ * directly the matrix' coefficients. The view keeps its matrix alive.
+ *
+ * Views are created with {Eigen::MatrixX#block}, {Eigen::MatrixX#row_view}
+ * and {Eigen::MatrixX#col_view}. Methods that take a matrix argument accept
+ * either a {Eigen::MatrixX} or a view. Operations that do not modify the
+ * view return a new {Eigen::MatrixX}.
+ *
+ * If the matrix is resized so that the block does not fit in it anymore,
+ * using the view raises IndexError.
+ *
+ * @!method rows
+ *    @return [Integer] the number of rows
+ * @!method cols
+ *    @return [Integer] the number of columns
+ * @!method size
+ *    @return [Integer] the number of elements
+ * @!method [](row, col)
+ *    Accesses an element
+ *    @return [Numeric]
+ * @!method []=(row, col, value)
+ *    Sets an element of the underlying matrix
+ *    @return [Numeric]
+ * @!method to_a(column_major = true)
+ *    Returns the values flattened in a ruby array
+ *    @return [Array<Float>]
+ * @!method to_matrix
+ *    Returns a copy of the block
+ *    @return [MatrixX]
+ * @!method replace(m)
+ *    Copies the values of a matrix of the same size into the block
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [void]
+ * @!method +(m)
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [MatrixX] the sum
+ * @!method -(m)
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [MatrixX] the subtraction
+ * @!method *(scalar)
+ *    @param [Numeric] scalar
+ *    @return [MatrixX] the result
+ * @!method /(scalar)
+ *    @param [Numeric] scalar
+ *    @return [MatrixX] the result
+ * @!method -@()
+ *    @return [MatrixX] the negation
+ * @!method add!(m)
+ *    In-place sum
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [void]
+ * @!method sub!(m)
+ *    In-place subtraction
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
+ * @!method norm
+ *    @return [Numeric] the block's norm
+ * @!method dotV(v)
+ *    Matrix-vector product
+ *    @param [VectorX] v
+ *    @return [VectorX]
+ * @!method dotM(m)
+ *    Matrix product
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [MatrixX]
+ * @!method approx?(m, threshold = dummy_precision)
+ *    Verifies that two matrices are within threshold of each other, elementwise
+ *    @param [MatrixX,MatrixXView] m
+ *    @return [Boolean]
+ */
+template<typename Scalar>
+struct BasicMatrixXView
+{
+    typedef BasicMatrixX<Scalar> Matrix;
+    typedef Eigen::Map<EigenMatrixX<Scalar>, Eigen::Unaligned, Eigen::OuterStride<> > MapType;
+
+    Matrix* matrix;
+    long row, col, view_rows, view_cols;
+
+    BasicMatrixXView(Matrix* matrix, long row, long col, long rows, long cols)
+        : matrix(matrix), row(row), col(col), view_rows(rows), view_cols(cols) {}
+
+    /* Maps the block onto the matrix' current storage */
+    MapType map() const
+    {
+        matrix->checkReadable();
+        EigenMatrixX<Scalar>& m = matrix->m;
+        if (row + view_rows > m.rows() || col + view_cols > m.cols())
+            throw Exception(rb_eIndexError, "the %lix%li view at (%li, %li) does not fit in its %lix%li matrix anymore",
+                    view_rows, view_cols, row, col,
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()));
+        return MapType(m.data() + col * m.rows() + row, view_rows, view_cols,
+                Eigen::OuterStride<>(m.rows()));
+    }
+
+    /* Maps a MatrixX or a view, and sets owner to the matrix holding the data */
+    static MapType mapOperand(Object value, Matrix*& owner)
+    {
+        if (rb_obj_is_kind_of(value, Data_Type<BasicMatrixXView>::klass()))
+        {
+            BasicMatrixXView* view = Data_Type<BasicMatrixXView>::from_ruby(value);
+            owner = view->matrix;
+            return view->map();
+        }
+        owner = Data_Type<Matrix>::from_ruby(value);
+        return MapType(owner->m.data(), owner->m.rows(), owner->m.cols(),
+                Eigen::OuterStride<>(owner->m.rows()));
+    }
+
+    void checkIndex(int i, int j) const
+    {
+        if (i < 0 || i >= view_rows || j < 0 || j >= view_cols)
+            throw Exception(rb_eIndexError, "(%i, %i) out of bounds of a %lix%li view",
+                    i, j, view_rows, view_cols);
+    }
+
+    int rows() const { return view_rows; }
+    int cols() const { return view_cols; }
+    int size() const { return view_rows * view_cols; }
+
+    double get(int i, int j) const { checkIndex(i, j); return map()(i, j); }
+    void set(int i, int j, double value)
+    {
+        checkIndex(i, j);
+        matrix->checkWritable();
+        map()(i, j) = value;
+    }
+
+    Array toArray(bool column_major) const
+    { return ::toArray(map(), column_major); }
+    Matrix* toMatrix() const
+    { return new Matrix(map()); }
+
+    void replace(Object other)
+    {
+        matrix->checkWritable();
+        Matrix* owner;
+        MapType src = mapOperand(other, owner);
+        MapType dst = map();
+        checkSameSize(dst, src);
+        if (owner == matrix)
+            dst = src.eval();
+        else
+            dst = src;
+    }
+
+    Matrix* operator + (Object other) const
+    {
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        return new Matrix(lhs + rhs);
+    }
+    Matrix* operator - (Object other) const
+    {
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        return new Matrix(lhs - rhs);
+    }
+    Matrix* scale(double scalar) const
+    { return new Matrix(map() * static_cast<Scalar>(scalar)); }
+    Matrix* operator / (double scalar) const
+    { return new Matrix(map() / static_cast<Scalar>(scalar)); }
+    Matrix* negate() const
+    { return new Matrix(-map()); }
+
+    void addBang(Object other)
+    {
+        matrix->checkWritable();
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        if (owner == matrix)
+            lhs += rhs.eval();
+        else
+            lhs += rhs;
+    }
+    void subBang(Object other)
+    {
+        matrix->checkWritable();
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        if (owner == matrix)
+            lhs -= rhs.eval();
+        else
+            lhs -= rhs;
+    }
+    void scaleBang(double scalar)
+    {
+        matrix->checkWritable();
+        map() *= static_cast<Scalar>(scalar);
+    }
+
+    double norm() const { return map().norm(); }
+
+    BasicVectorX<Scalar>* dotV(BasicVectorX<Scalar> const& other) const
+    {
+        MapType lhs = map();
+        if (lhs.cols() != other.v.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a vector of size %li",
+                    static_cast<long>(lhs.rows()), static_cast<long>(lhs.cols()),
+                    static_cast<long>(other.v.rows()));
+
+        std::unique_ptr< BasicVectorX<Scalar> > result(new BasicVectorX<Scalar>(lhs.rows()));
+        NoGVLGuard guard_self(*matrix), guard_other(other);
+        computeWithoutGVL(lhs.rows() * lhs.cols(), [&]() { result->v.noalias() = lhs * other.v; });
+        return result.release();
+    }
+
+    Matrix* dotM(Object other) const
+    {
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        if (lhs.cols() != rhs.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a %lix%li matrix",
+                    static_cast<long>(lhs.rows()), static_cast<long>(lhs.cols()),
+                    static_cast<long>(rhs.rows()), static_cast<long>(rhs.cols()));
+
+        std::unique_ptr<Matrix> result(new Matrix(lhs.rows(), rhs.cols()));
+        NoGVLGuard guard_self(*matrix), guard_other(*owner);
+        computeWithoutGVL(lhs.rows() * lhs.cols() * rhs.cols(),
+                [&]() { result->m.noalias() = lhs * rhs; });
+        return result.release();
+    }
+
+    bool isApprox(Object other, double tolerance) const
+    {
+        Matrix* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        return lhs.rows() == rhs.rows() && lhs.cols() == rhs.cols() &&
+            lhs.isApprox(rhs, tolerance);
+    }
+};
+
+typedef BasicMatrixXView<double> MatrixXView;
+typedef BasicMatrixXView<float> MatrixXfView;
+
+/* 
+ * Document-class: Eigen::VectorXView
+ *
+ * A contiguous segment of a {Eigen::VectorX}, which reads and writes
+ * directly the vector's coefficients. The view keeps its vector alive.
+ *
+ * Views are created with {Eigen::VectorX#segment}, {Eigen::VectorX#head} and
+ * {Eigen::VectorX#tail}. Methods that take a vector argument accept either
+ * a {Eigen::VectorX} or a view. Operations that do not modify the view
+ * return a new {Eigen::VectorX}.
+ *
+ * If the vector is resized so that the segment does not fit in it anymore,
+ * using the view raises IndexError.
+ *
+ * @!method size
+ *    @return [Integer] the number of elements
+ * @!method [](index)
+ *    @return [Numeric] an element
+ * @!method []=(index, value)
+ *    Sets an element of the underlying vector
+ *    @return [Numeric]
+ * @!method to_a
+ *    @return [Array<Float>] the elements
+ * @!method to_vector
+ *    Returns a copy of the segment
+ *    @return [VectorX]
+ * @!method replace(v)
+ *    Copies the values of a vector of the same size into the segment
+ *    @param [VectorX,VectorXView] v
+ *    @return [void]
+ * @!method +(v)
+ *    @param [VectorX,VectorXView] v
+ *    @return [VectorX] the sum
+ * @!method -(v)
+ *    @param [VectorX,VectorXView] v
+ *    @return [VectorX] the subtraction
+ * @!method *(scalar)
+ *    @param [Numeric] scalar
+ *    @return [VectorX] the result
+ * @!method /(scalar)
+ *    @param [Numeric] scalar
+ *    @return [VectorX] the result
+ * @!method -@()
+ *    @return [VectorX] the negation
+ * @!method add!(v)
+ *    In-place sum
+ *    @param [VectorX,VectorXView] v
+ *    @return [void]
+ * @!method sub!(v)
+ *    In-place subtraction
+ *    @param [VectorX,VectorXView] v
+ *    @return [void]
+ * @!method scale!(scalar)
+ *    In-place multiplication by a scalar
+ *    @param [Numeric] scalar
+ *    @return [void]
+ * @!method norm
+ *    @return [Numeric] the segment's norm
+ * @!method dot(v)
+ *    Dot product
+ *    @param [VectorX,VectorXView] v
+ *    @return [Numeric]
+ * @!method approx?(v, threshold = dummy_precision)
+ *    Verifies that two vectors are within threshold of each other, elementwise
+ *    @param [VectorX,VectorXView] v
+ *    @return [Boolean]
+ */
+template<typename Scalar>
+struct BasicVectorXView
+{
+    typedef BasicVectorX<Scalar> Vector;
+    typedef Eigen::Map<EigenVectorX<Scalar>, Eigen::Unaligned> MapType;
+
+    Vector* vector;
+    long start, view_size;
+
+    BasicVectorXView(Vector* vector, long start, long size)
+        : vector(vector), start(start), view_size(size) {}
+
+    /* Maps the segment onto the vector's current storage */
+    MapType map() const
+    {
+        vector->checkReadable();
+        EigenVectorX<Scalar>& v = vector->v;
+        if (start + view_size > v.size())
+            throw Exception(rb_eIndexError, "the view of size %li at %li does not fit in its vector of size %li anymore",
+                    view_size, start, static_cast<long>(v.size()));
+        return MapType(v.data() + start, view_size);
+    }
+
+    /* Maps a VectorX or a view, and sets owner to the vector holding the data */
+    static MapType mapOperand(Object value, Vector*& owner)
+    {
+        if (rb_obj_is_kind_of(value, Data_Type<BasicVectorXView>::klass()))
+        {
+            BasicVectorXView* view = Data_Type<BasicVectorXView>::from_ruby(value);
+            owner = view->vector;
+            return view->map();
+        }
+        owner = Data_Type<Vector>::from_ruby(value);
+        return MapType(owner->v.data(), owner->v.size());
+    }
+
+    void checkIndex(int i) const
+    {
+        if (i < 0 || i >= view_size)
+            throw Exception(rb_eIndexError, "index %i out of bounds (size %li)", i, view_size);
+    }
+
+    int size() const { return view_size; }
+
+    double get(int i) const { checkIndex(i); return map()[i]; }
+    void set(int i, double value)
+    {
+        checkIndex(i);
+        vector->checkWritable();
+        map()[i] = value;
+    }
+
+    Array toArray() const { return ::toArray(map(), true); }
+    Vector* toVector() const { return new Vector(map()); }
+
+    void replace(Object other)
+    {
+        vector->checkWritable();
+        Vector* owner;
+        MapType src = mapOperand(other, owner);
+        MapType dst = map();
+        checkSameSize(dst, src);
+        if (owner == vector)
+            dst = src.eval();
+        else
+            dst = src;
+    }
+
+    Vector* operator + (Object other) const
+    {
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        return new Vector(lhs + rhs);
+    }
+    Vector* operator - (Object other) const
+    {
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        return new Vector(lhs - rhs);
+    }
+    Vector* scale(double scalar) const
+    { return new Vector(map() * static_cast<Scalar>(scalar)); }
+    Vector* operator / (double scalar) const
+    { return new Vector(map() / static_cast<Scalar>(scalar)); }
+    Vector* negate() const
+    { return new Vector(-map()); }
+
+    void addBang(Object other)
+    {
+        vector->checkWritable();
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        if (owner == vector)
+            lhs += rhs.eval();
+        else
+            lhs += rhs;
+    }
+    void subBang(Object other)
+    {
+        vector->checkWritable();
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        if (owner == vector)
+            lhs -= rhs.eval();
+        else
+            lhs -= rhs;
+    }
+    void scaleBang(double scalar)
+    {
+        vector->checkWritable();
+        map() *= static_cast<Scalar>(scalar);
+    }
+
+    double norm() const { return map().norm(); }
+
+    double dot(Object other) const
+    {
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        checkSameSize(lhs, rhs);
+        return lhs.dot(rhs);
+    }
+
+    bool isApprox(Object other, double tolerance) const
+    {
+        Vector* owner;
+        MapType rhs = mapOperand(other, owner);
+        MapType lhs = map();
+        return lhs.size() == rhs.size() && lhs.isApprox(rhs, tolerance);
+    }
+};
+
+typedef BasicVectorXView<double> VectorXView;
+typedef BasicVectorXView<float> VectorXfView;
+
+/* Wraps a view, keeping the Ruby object it refers to alive */
+template<typename View>
+static Object wrapView(Object parent, View* view)
+{
+    Data_Object<View> result(view);
+    result.iv_set("@parent", parent);
+    return result;
+}
+
+/* Implementation of MatrixX#block */
+template<typename Scalar>
+static Object matrixBlock(Object self, int row, int col, int rows, int cols)
+{
+    BasicMatrixX<Scalar>* matrix = Data_Type< BasicMatrixX<Scalar> >::from_ruby(self);
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 ||
+            row + rows > matrix->m.rows() || col + cols > matrix->m.cols())
+        throw Exception(rb_eIndexError, "a %ix%i block at (%i, %i) does not fit in a %lix%li matrix",
+                rows, cols, row, col,
+                static_cast<long>(matrix->m.rows()), static_cast<long>(matrix->m.cols()));
+    return wrapView(self, new BasicMatrixXView<Scalar>(matrix, row, col, rows, cols));
+}
+
+/* Implementation of MatrixX#row_view */
+template<typename Scalar>
+static Object matrixRowView(Object self, int row)
+{
+    BasicMatrixX<Scalar>* matrix = Data_Type< BasicMatrixX<Scalar> >::from_ruby(self);
+    return matrixBlock<Scalar>(self, row, 0, 1, matrix->m.cols());
+}
+
+/* Implementation of MatrixX#col_view */
+template<typename Scalar>
+static Object matrixColView(Object self, int col)
+{
+    BasicMatrixX<Scalar>* matrix = Data_Type< BasicMatrixX<Scalar> >::from_ruby(self);
+    return matrixBlock<Scalar>(self, 0, col, matrix->m.rows(), 1);
+}
+
+/* Implementation of VectorX#segment */
+template<typename Scalar>
+static Object vectorSegment(Object self, int start, int size)
+{
+    BasicVectorX<Scalar>* vector = Data_Type< BasicVectorX<Scalar> >::from_ruby(self);
+    if (start < 0 || size < 0 || start + size > vector->v.size())
+        throw Exception(rb_eIndexError, "a segment of size %i at %i does not fit in a vector of size %li",
+                size, start, static_cast<long>(vector->v.size()));
+    return wrapView(self, new BasicVectorXView<Scalar>(vector, start, size));
+}
+
+/* Implementation of VectorX#head */
+template<typename Scalar>
+static Object vectorHead(Object self, int size)
+{ return vectorSegment<Scalar>(self, 0, size); }
+
+/* Implementation of VectorX#tail */
+template<typename Scalar>
+static Object vectorTail(Object self, int size)
+{
+    BasicVectorX<Scalar>* vector = Data_Type< BasicVectorX<Scalar> >::from_ruby(self);
+    return vectorSegment<Scalar>(self, vector->v.size() - size, size);
+}
+
+/* Solves decomposition * x = b for a VectorX or MatrixX right-hand side
+ *
+ * The result is written in out, or in a new object if out is nil. out may
+ * be the right-hand side itself.
+ */
+template<typename Wrapper, typename Storage, typename Decomposition>
+static Object solveInto(Decomposition const& d, NoGVLUsage const& owner,
+        Storage Wrapper::* storage, Object rhs, Object out)
+{
+    Wrapper const& b = *Data_Type<Wrapper>::from_ruby(rhs);
+    if (d.rows() != (b.*storage).rows())
+        throw Exception(rb_eArgError, "expected a right-hand side with %li rows, got %li",
+                static_cast<long>(d.rows()), static_cast<long>((b.*storage).rows()));
+
+    std::unique_ptr<Wrapper> owned;
+    Wrapper* result;
+    if (out.is_nil())
+    {
+        owned.reset(new Wrapper());
+        result = owned.get();
+    }
+    else
+    {
+        result = Data_Type<Wrapper>::from_ruby(out);
+        result->checkWritable();
+    }
+
+    // Buffers visible from Ruby are only (re)allocated or freed with the GVL
+    // held, as other threads may be reading them meanwhile. When out is the
+    // right-hand side, the solution is computed into a local and swapped in
+    // afterwards
+    Storage local;
+    Storage& x = (result == &b) ? local : result->*storage;
+    x.resize(d.cols(), (b.*storage).cols());
+    {
+        NoGVLGuard guard_self(owner), guard_b(b), guard_result(*result, result != &b);
+        long cost = d.rows() * d.cols() * (b.*storage).cols();
+        computeWithoutGVL(cost, [&]() { x.noalias() = d.solve(b.*storage); });
+    }
+    if (result == &b)
+        (result->*storage).swap(local);
+
+    if (owned)
+        return Data_Object<Wrapper>(owned.release());
+    return out;
+}
+
+/* Solves decomposition * x = rhs, where rhs is either a VectorX or a MatrixX
+ *
+ * @param owner the wrapper of the decomposition
+ * @param out optional object of the same type than rhs the result is
+ *   written into
+ * @return [VectorX,MatrixX] x, of the same type than rhs
+ */
+template<typename Decomposition>
+static Object solveWith(Decomposition const& d, NoGVLUsage const& owner, Object rhs, Object out)
+{
+    if (rb_obj_is_kind_of(rhs, Data_Type<VectorX>::klass()))
+        return solveInto(d, owner, &VectorX::v, rhs, out);
+    else
+        return solveInto(d, owner, &MatrixX::m, rhs, out);
+}
+
+/* Whether a decomposition can only be computed on square matrices */
+template<typename Decomposition>
+static bool requiresSquareMatrix() { return true; }
+template<>
+bool requiresSquareMatrix< Eigen::ColPivHouseholderQR<Eigen::MatrixXd> >() { return false; }
+
+static double determinantOf(Eigen::LLT<Eigen::MatrixXd> const& d)
+{
+    double det = d.matrixLLT().diagonal().prod();
+    return det * det;
+}
+static double determinantOf(Eigen::LDLT<Eigen::MatrixXd> const& d)
+{ return d.vectorD().prod(); }
+static double determinantOf(Eigen::PartialPivLU<Eigen::MatrixXd> const& d)
+{ return d.determinant(); }
+
+/* 
+ * Document-class: Eigen::LLT
+ *
+ * Cholesky factorization of a symmetric positive-definite matrix
+ *
+ * It is usually created with {Eigen::MatrixX#llt}. An existing object can
+ * be recomputed with {#compute}, which reuses its buffers.
+ *
+ * @!method initialize
+ *   Creates an empty factorization. Call {#compute} before using it.
+ * @!method compute(matrix)
+ *   Factorizes a new matrix
+ *   @param [MatrixX] matrix
+ *   @return [void]
+ * @!method solve(rhs, out = nil)
+ *   Solves matrix * x = rhs
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object
+ *   @return [VectorX,MatrixX] x, of the same type than rhs
+ * @!method success?
+ *   Whether the factorization succeeded, i.e. the matrix was positive
+ *   definite
+ *   @return [Boolean]
+ * @!method determinant
+ *   The determinant of the factorized matrix
+ *   @return [Float]
+ * @!method rcond
+ *   An estimate of the reciprocal condition number of the matrix
+ *   @return [Float]
+ */
+
+/* 
+ * Document-class: Eigen::LDLT
+ *
+ * Robust Cholesky factorization of a symmetric positive or negative
+ * semi-definite matrix
+ *
+ * It is usually created with {Eigen::MatrixX#ldlt}. An existing object can
+ * be recomputed with {#compute}, which reuses its buffers.
+ *
+ * @!method initialize
+ *   Creates an empty factorization. Call {#compute} before using it.
+ * @!method compute(matrix)
+ *   Factorizes a new matrix
+ *   @param [MatrixX] matrix
+ *   @return [void]
+ * @!method solve(rhs, out = nil)
+ *   Solves matrix * x = rhs
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object
+ *   @return [VectorX,MatrixX] x, of the same type than rhs
+ * @!method success?
+ *   Whether the factorization succeeded
+ *   @return [Boolean]
+ * @!method determinant
+ *   The determinant of the factorized matrix
+ *   @return [Float]
+ * @!method rcond
+ *   An estimate of the reciprocal condition number of the matrix
+ *   @return [Float]
+ */
+
+/* 
+ * Document-class: Eigen::PartialPivLU
+ *
+ * LU factorization with partial pivoting of an invertible matrix
+ *
+ * It is usually created with {Eigen::MatrixX#lu}. An existing object can
+ * be recomputed with {#compute}, which reuses its buffers.
+ *
+ * @!method initialize
+ *   Creates an empty factorization. Call {#compute} before using it.
+ * @!method compute(matrix)
+ *   Factorizes a new matrix
+ *   @param [MatrixX] matrix
+ *   @return [void]
+ * @!method solve(rhs, out = nil)
+ *   Solves matrix * x = rhs
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object
+ *   @return [VectorX,MatrixX] x, of the same type than rhs
+ * @!method determinant
+ *   The determinant of the factorized matrix
+ *   @return [Float]
+ * @!method rcond
+ *   An estimate of the reciprocal condition number of the matrix
+ *   @return [Float]
+ */
+
+/* 
+ * Document-class: Eigen::ColPivHouseholderQR
+ *
+ * Householder QR factorization with column pivoting. Unlike the other
+ * factorizations, it handles rectangular and rank-deficient matrices, and
+ * solves in the least-squares sense.
+ *
+ * It is usually created with {Eigen::MatrixX#qr}. An existing object can
+ * be recomputed with {#compute}, which reuses its buffers.
+ *
+ * @!method initialize
+ *   Creates an empty factorization. Call {#compute} before using it.
+ * @!method compute(matrix)
+ *   Factorizes a new matrix
+ *   @param [MatrixX] matrix
+ *   @return [void]
+ * @!method solve(rhs, out = nil)
+ *   Solves matrix * x = rhs in the least-squares sense
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object
+ *   @return [VectorX,MatrixX] x, of the same type than rhs
+ * @!method rank
+ *   The rank of the factorized matrix
+ *   @return [Integer]
+ * @!method abs_determinant
+ *   The absolute value of the determinant of the factorized matrix
+ *   @return [Float]
+ */
+template<typename Decomposition>
+struct Factorization : NoGVLUsage
+{
+    Decomposition d;
+    bool computed;
+
+    Factorization() : computed(false) {}
+
+    void compute(MatrixX const& matrix)
+    { computeFrom(matrix.m, matrix); }
+
+    /* Factorizes a dense Eigen object held by the wrapper owner */
+    template<typename Input>
+    void computeFrom(Input const& matrix, NoGVLUsage const& owner)
+    {
+        checkWritable();
+        if (requiresSquareMatrix<Decomposition>() && matrix.rows() != matrix.cols())
+            throw Exception(rb_eArgError, "expected a square matrix, got %lix%li",
+                    static_cast<long>(matrix.rows()), static_cast<long>(matrix.cols()));
+
+        // Mark as not computed while the computation runs, so that
+        // concurrent readers raise instead of accessing a partial result
+        computed = false;
+        NoGVLGuard guard_matrix(owner), guard_self(*this, true);
+        computeWithoutGVL(matrix.rows() * matrix.cols() * std::min(matrix.rows(), matrix.cols()),
+                [&]() { d.compute(matrix); });
+        computed = true;
+    }
+
+    void checkComputed() const
+    {
+        if (!computed)
+            throw Exception(rb_eRuntimeError, "the factorization has not been computed");
+    }
+
+    Object solve(Object rhs, Object out) const
+    {
+        checkComputed();
+        return solveWith(d, *this, rhs, out);
+    }
+
+    bool success() const
+    {
+        checkComputed();
+        return d.info() == Eigen::Success;
+    }
+
+    double determinant() const
+    {
+        checkComputed();
+        return determinantOf(d);
+    }
+
+    double rcond() const
+    {
+        checkComputed();
+        return d.rcond();
+    }
+
+    int rank() const
+    {
+        checkComputed();
+        return d.rank();
+    }
+
+    double absDeterminant() const
+    {
+        checkComputed();
+        return d.absDeterminant();
+    }
+};
+
+template<typename Decomposition, typename Input>
+static Factorization<Decomposition>* factorize(Input const& matrix, NoGVLUsage const& owner)
+{
+    std::unique_ptr< Factorization<Decomposition> > result(new Factorization<Decomposition>());
+    result->computeFrom(matrix, owner);
+    return result.release();
+}
+
+/* 
+ * Document-class: Eigen::JacobiSVD
+ *
+ * Two-sided Jacobi singular value decomposition. It is the most accurate
+ * algorithm, but becomes slow above a few hundred columns.
+ *
+ * This is not constructed directly. Use {Eigen::MatrixX#svd} or
+ * {Eigen::MatrixX#jacobiSvd} instead.
+ *
+ * @!method solve(rhs, out = nil)
+ *   Solves the linear problem in the least-squares sense. Passing a MatrixX
+ *   solves for all its columns at once
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object. It must be of the same type than rhs
+ *   @return [VectorX,MatrixX] the result
+ *   @raise [RuntimeError] if U or V were not computed
+ * @!method singular_values
+ *   The singular values, sorted in decreasing order
+ *   @return [VectorX]
+ * @!method matrix_u
+ *   The left singular vectors. Raises if the decomposition was not computed
+ *   with Eigen::ComputeFullU or Eigen::ComputeThinU
+ *   @return [MatrixX]
+ * @!method matrix_v
+ *   The right singular vectors. Raises if the decomposition was not computed
+ *   with Eigen::ComputeFullV or Eigen::ComputeThinV
+ *   @return [MatrixX]
+ * @!method rank
+ *   The number of singular values above {#threshold} times the largest one
+ *   @return [Integer]
+ * @!method threshold
+ *   The relative threshold under which singular values are considered zero
+ *   @return [Float]
+ * @!method threshold=(value)
+ *   Overrides the default threshold. It affects {#rank} and {#solve}
+ *   @param [Float] value
+ */
+
+/* 
+ * Document-class: Eigen::BDCSVD
+ *
+ * Bidiagonal divide-and-conquer singular value decomposition, meant for
+ * large matrices. It has the same API than {Eigen::JacobiSVD}
+ *
+ * This is not constructed directly. Use {Eigen::MatrixX#svd} or
+ * {Eigen::MatrixX#bdcSvd} instead.
+ */
+template<typename Solver>
+struct SVD : NoGVLUsage
+{
+    Solver j;
+
+    /* Decomposes a dense Eigen object held by the wrapper owner */
+    template<typename Input>
+    void compute(Input const& matrix, NoGVLUsage const& owner, int flags)
+    {
+        if ((flags & Eigen::ComputeFullU) && (flags & Eigen::ComputeThinU))
+            throw Exception(rb_eArgError, "cannot compute both a full and a thin U, pass either Eigen::ComputeFullU or Eigen::ComputeThinU");
+        if ((flags & Eigen::ComputeFullV) && (flags & Eigen::ComputeThinV))
+            throw Exception(rb_eArgError, "cannot compute both a full and a thin V, pass either Eigen::ComputeFullV or Eigen::ComputeThinV");
+        NoGVLGuard guard_matrix(owner), guard_self(*this, true);
+        computeWithoutGVL(matrix.rows() * matrix.cols() * std::min(matrix.rows(), matrix.cols()),
+                [&]() { j.compute(matrix, flags); });
+    }
+
+    Object solve(Object rhs, Object out) const
+    {
+        if (!j.computeU() || !j.computeV())
+            throw Exception(rb_eRuntimeError, "U and V were not computed, pass Eigen::ComputeThinU | Eigen::ComputeThinV");
+        return solveWith(j, *this, rhs, out);
+    }
+
+    VectorX* singularValues() const
+    {
+        std::unique_ptr<VectorX> result(new VectorX());
+        result->v = j.singularValues();
+        return result.release();
+    }
+
+    MatrixX* matrixU() const
+    {
+        if (!j.computeU())
+            throw Exception(rb_eRuntimeError, "U was not computed, pass Eigen::ComputeFullU or Eigen::ComputeThinU");
+        std::unique_ptr<MatrixX> result(new MatrixX());
+        result->m = j.matrixU();
+        return result.release();
+    }
+
+    MatrixX* matrixV() const
+    {
+        if (!j.computeV())
+            throw Exception(rb_eRuntimeError, "V was not computed, pass Eigen::ComputeFullV or Eigen::ComputeThinV");
+        std::unique_ptr<MatrixX> result(new MatrixX());
+        result->m = j.matrixV();
+        return result.release();
+    }
+
+    int rank() const
+    { return j.rank(); }
+
+    double threshold() const
+    { return j.threshold(); }
+
+    void setThreshold(double value)
+    {
+        checkWritable();
+        if (value <= 0)
+            throw Exception(rb_eArgError, "the threshold must be strictly positive");
+        j.setThreshold(value);
+    }
+};
+
+template<typename Solver, typename Input>
+static SVD<Solver>* decompose(Input const& matrix, NoGVLUsage const& owner, int flags)
+{
+    std::unique_ptr< SVD<Solver> > result(new SVD<Solver>());
+    result->compute(matrix, owner, flags);
+    return result.release();
+}
+
+template<>
+JacobiSVD* MatrixX::jacobiSvd(int flags) const
+{ return decompose< Eigen::JacobiSVD<Eigen::MatrixXd> >(m, *this, flags); }
+template<>
+BDCSVD* MatrixX::bdcSvd(int flags) const
+{ return decompose< Eigen::BDCSVD<Eigen::MatrixXd> >(m, *this, flags); }
+
+template<>
+LLT* MatrixX::llt() const
+{ return factorize< Eigen::LLT<Eigen::MatrixXd> >(m, *this); }
+template<>
+LDLT* MatrixX::ldlt() const
+{ return factorize< Eigen::LDLT<Eigen::MatrixXd> >(m, *this); }
+template<>
+PartialPivLU* MatrixX::lu() const
+{ return factorize< Eigen::PartialPivLU<Eigen::MatrixXd> >(m, *this); }
+template<>
+ColPivHouseholderQR* MatrixX::qr() const
+{ return factorize< Eigen::ColPivHouseholderQR<Eigen::MatrixXd> >(m, *this); }
+
+/* Raises ArgumentError if k principal components cannot be computed in the
+ * given dimension */
+static void checkComponentCount(int k, long dim)
+{
+    if (k < 1 || k > dim)
+        throw Exception(rb_eArgError, "cannot compute %i principal components in dimension %li", k, dim);
+}
+
+/* Wraps the results of computePrincipalComponents as [axes, variances] */
+static Array principalComponentsResult(std::unique_ptr<MatrixX> axes, std::unique_ptr<VectorX> variances)
+{
+    Array result;
+    result.push(Data_Object<MatrixX>(axes.release()));
+    result.push(Data_Object<VectorX>(variances.release()));
+    return result;
+}
+
+template<>
+Array MatrixX::principalComponents(int k, bool rowwise) const
+{
+    long dim = rowwise ? m.cols() : m.rows();
+    long count = rowwise ? m.rows() : m.cols();
+    checkComponentCount(k, dim);
+    checkObservationCount(count);
+
+    std::unique_ptr<MatrixX> axes(new MatrixX());
+    std::unique_ptr<VectorX> variances(new VectorX());
+    NoGVLGuard guard(*this);
+    computeWithoutGVL(dim * count * std::min(dim, count), [&]() {
+        Eigen::MatrixXd axes_;
+        Eigen::VectorXd variances_;
+        if (rowwise)
+            computePrincipalComponents(m.transpose(), k, axes_, variances_);
+        else
+            computePrincipalComponents(m, k, axes_, variances_);
+        axes->m = axes_;
+        variances->v = variances_;
+    });
+    return principalComponentsResult(std::move(axes), std::move(variances));
+}
+
+MatrixX* Vector3Array::covariance() const
+{
+    checkObservationCount(points.cols());
+    Eigen::Matrix3d result;
+    computeCovariance(points, result);
+    return new MatrixX(result);
+}
+
+Array Vector3Array::principalComponents(int k) const
+{
+    checkComponentCount(k, 3);
+    checkObservationCount(points.cols());
+
+    Eigen::MatrixXd axes;
+    Eigen::VectorXd variances;
+    computePrincipalComponents(points, k, axes, variances);
+    return principalComponentsResult(
+            std::unique_ptr<MatrixX>(new MatrixX(axes)),
+            std::unique_ptr<VectorX>(new VectorX(variances)));
+}
+
+/* Converts a Ruby numeric into an element of a triplet buffer */
+static void fromRubyElement(VALUE value, int32_t& out) { out = NUM2INT(value); }
+static void fromRubyElement(VALUE value, double& out) { out = num2dbl(value); }
+
+/* Reads a buffer of values given either as an Array or as a packed String
+ *
+ * Strings are read in native byte order, i.e. are expected to be generated by
+ * Array#pack("l*") for 32-bit integers and Array#pack("d*") for doubles. They
+ * are copied in one go, without creating any Ruby object.
+ */
+template<typename T>
+static std::vector<T> readPackedBuffer(Object buffer, char const* name)
+{
+    VALUE value = buffer.value();
+    std::vector<T> result;
+    if (RB_TYPE_P(value, T_STRING))
+    {
+        long length = RSTRING_LEN(value);
+        if (length % sizeof(T) != 0)
+            throw Exception(rb_eArgError, "the %s buffer should be a multiple of %li bytes, got %li",
+                    name, static_cast<long>(sizeof(T)), length);
+        result.resize(length / sizeof(T));
+        if (length)
+            std::memcpy(result.data(), RSTRING_PTR(value), length);
+    }
+    else
+    {
+        Check_Type(value, T_ARRAY);
+        long size = RARRAY_LEN(value);
+        result.resize(size);
+        for (long i = 0; i < size; ++i)
+            fromRubyElement(RARRAY_AREF(value, i), result[i]);
+    }
+    return result;
+}
+
+/*
+ * Document-class: Eigen::SparseMatrix
+ *
+ * A variable-size sparse matrix holding floating-point numbers, stored in
+ * compressed column-major form
+ *
+ * It is meant to be filled in one call with {#set_from_triplets} or
+ * {SparseMatrix.from_triplets}, and solved with {SimplicialLDLT},
+ * {SparseLU} or {ConjugateGradient}. Products with dense operands release
+ * the GVL when large enough.
+ *
+ * @!method initialize(rows = 0, cols = 0)
+ *    Creates an empty matrix
+ *    @param [Integer] rows the number of rows
+ *    @param [Integer] cols the number of columns
+ * @!method rows
+ *    @return [Integer] the number of rows
+ * @!method cols
+ *    @return [Integer] the number of columns
+ * @!method nonzeros
+ *    @return [Integer] the number of explicitly stored coefficients
+ * @!method memsize
+ *    @return [Integer] the number of bytes used by the matrix, including its
+ *      coefficients and indices
+ * @!method resize(rows, cols)
+ *    Resizes the matrix and removes all its coefficients
+ *    @param [Integer] rows the new number of rows
+ *    @param [Integer] cols the new number of columns
+ * @!method set_from_triplets(row_indices, col_indices, values)
+ *    Replaces the coefficients of the matrix
+ *
+ *    The three buffers are either arrays or strings packed with
+ *    Array#pack("l*") for the indices and Array#pack("d*") for the values.
+ *    Coefficients given more than once are summed.
+ *
+ *    @param [Array<Integer>,String] row_indices
+ *    @param [Array<Integer>,String] col_indices
+ *    @param [Array<Numeric>,String] values
+ *    @return [void]
+ *    @raise [ArgumentError] if the buffers do not have the same size
+ *    @raise [IndexError] if an index is out of the matrix
+ * @!method to_triplets
+ *    Returns the stored coefficients
+ *    @return [(Array<Integer>,Array<Integer>,Array<Float>)] the row indices,
+ *      column indices and values in column-major order
+ * @!method [](row, col)
+ *    Accesses an element. This is a binary search, prefer the bulk methods
+ *    @return [Float] the element, zero if it is not stored
+ * @!method from_dense(matrix, reference = 1.0, epsilon = 0.0)
+ *    Sets this matrix from the coefficients of a dense one. Coefficients
+ *    that are negligible compared to reference are dropped
+ *    @param [MatrixX] matrix
+ *    @return [void]
+ * @!method to_dense
+ *    @return [MatrixX] the dense version of this matrix
+ * @!method T
+ *    @return [SparseMatrix] the transposed matrix
+ * @!method +(other)
+ *    @param [SparseMatrix] other
+ *    @return [SparseMatrix] the sum
+ * @!method -(other)
+ *    @param [SparseMatrix] other
+ *    @return [SparseMatrix] the difference
+ * @!method *(scalar)
+ *    @param [Numeric] scalar
+ *    @return [SparseMatrix] the matrix multiplied by scalar
+ * @!method dotV(vector)
+ *    Product with a dense vector
+ *    @param [VectorX] vector
+ *    @return [VectorX]
+ * @!method dotM(matrix)
+ *    Product with a dense matrix
+ *    @param [MatrixX] matrix
+ *    @return [MatrixX]
+ * @!method norm
+ *    @return [Float] the Frobenius norm
+ * @!method approx?(other, tolerance = dummy_precision)
+ *    @param [SparseMatrix] other
+ *    @return [Boolean]
+ */
+struct SparseMatrix : NoGVLUsage, ReportedMemsize
+{
+    typedef Eigen::SparseMatrix<double> EigenType;
+    EigenType m;
+
+    SparseMatrix() {}
+    SparseMatrix(int rows, int cols) : m(rows, cols) {}
+    SparseMatrix(EigenType const& _m) : m(_m) {}
+
+    unsigned int rows() const { return m.rows(); }
+    unsigned int cols() const { return m.cols(); }
+    unsigned int nonZeros() const { return m.nonZeros(); }
+
+    void resize(int rows, int cols) { checkWritable(); m.resize(rows, cols); }
+
+    size_t payloadSize() const
+    {
+        typedef EigenType::StorageIndex Index;
+        size_t size = m.data().allocatedSize() * (sizeof(double) + sizeof(Index)) +
+            (m.outerSize() + 1) * sizeof(Index);
+        if (!m.isCompressed())
+            size += m.outerSize() * sizeof(Index);
+        return size;
+    }
+    size_t memsize() const { return sizeof(*this) + payloadSize(); }
+    void reportMemsize() const { updateReportedMemsize(payloadSize()); }
+
+    double get(int i, int j) const
+    {
+        if (i < 0 || i >= m.rows() || j < 0 || j >= m.cols())
+            throw Exception(rb_eIndexError, "(%i, %i) is out of a %lix%li matrix",
+                    i, j, static_cast<long>(m.rows()), static_cast<long>(m.cols()));
+        return m.coeff(i, j);
+    }
+
+    void setFromTriplets(Object rowIndices, Object colIndices, Object values)
+    {
+        checkWritable();
+        std::vector<int32_t> r = readPackedBuffer<int32_t>(rowIndices, "row index");
+        std::vector<int32_t> c = readPackedBuffer<int32_t>(colIndices, "column index");
+        std::vector<double> v = readPackedBuffer<double>(values, "value");
+        if (r.size() != v.size() || c.size() != v.size())
+            throw Exception(rb_eArgError, "expected buffers of the same size, got %li row indices, %li column indices and %li values",
+                    static_cast<long>(r.size()), static_cast<long>(c.size()), static_cast<long>(v.size()));
+
+        std::vector< Eigen::Triplet<double> > triplets;
+        triplets.reserve(v.size());
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            if (r[i] < 0 || r[i] >= m.rows() || c[i] < 0 || c[i] >= m.cols())
+                throw Exception(rb_eIndexError, "triplet %li (%i, %i) is out of a %lix%li matrix",
+                        static_cast<long>(i), r[i], c[i],
+                        static_cast<long>(m.rows()), static_cast<long>(m.cols()));
+            triplets.emplace_back(r[i], c[i], v[i]);
+        }
+
+        // Built aside and swapped in with the GVL held, other threads may be
+        // reading m meanwhile
+        EigenType result(m.rows(), m.cols());
+        {
+            NoGVLGuard guard(*this);
+            computeWithoutGVL(triplets.size() * 16,
+                    [&]() { result.setFromTriplets(triplets.begin(), triplets.end()); });
+        }
+        m.swap(result);
+    }
+
+    Array toTriplets() const
+    {
+        VALUE r = rb_ary_new_capa(m.nonZeros());
+        VALUE c = rb_ary_new_capa(m.nonZeros());
+        VALUE v = rb_ary_new_capa(m.nonZeros());
+        for (int k = 0; k < m.outerSize(); ++k)
+        {
+            for (EigenType::InnerIterator it(m, k); it; ++it)
+            {
+                rb_ary_push(r, INT2FIX(it.row()));
+                rb_ary_push(c, INT2FIX(it.col()));
+                rb_ary_push(v, DBL2NUM(it.value()));
+            }
+        }
+        Array result;
+        result.push(Object(r));
+        result.push(Object(c));
+        result.push(Object(v));
+        return result;
+    }
+
+    void fromDense(MatrixX const& matrix, double reference, double epsilon)
+    {
+        checkWritable();
+        EigenType result;
+        {
+            NoGVLGuard guard_self(*this), guard_matrix(matrix);
+            computeWithoutGVL(matrix.m.size(),
+                    [&]() { result = matrix.m.sparseView(reference, epsilon); });
+        }
+        m.swap(result);
+    }
+
+    MatrixX* toDense() const
+    {
+        std::unique_ptr<MatrixX> result(new MatrixX());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(static_cast<long>(m.rows()) * m.cols(),
+                [&]() { result->m = m.toDense(); });
+        return result.release();
+    }
+
+    SparseMatrix* transpose() const
+    { return new SparseMatrix(m.transpose()); }
+
+    SparseMatrix* operator + (SparseMatrix const& other) const
+    {
+        checkSameSize(m, other.m);
+        return new SparseMatrix(m + other.m);
+    }
+
+    SparseMatrix* operator - (SparseMatrix const& other) const
+    {
+        checkSameSize(m, other.m);
+        return new SparseMatrix(m - other.m);
+    }
+
+    SparseMatrix* scale(double scalar) const
+    { return new SparseMatrix(m * scalar); }
+
+    VectorX* dotV(VectorX const& other) const
+    {
+        if (m.cols() != other.v.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a vector of size %li",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.v.rows()));
+
+        std::unique_ptr<VectorX> result(new VectorX(m.rows()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.nonZeros(), [&]() { result->v.noalias() = m * other.v; });
+        return result.release();
+    }
+
+    MatrixX* dotM(MatrixX const& other) const
+    {
+        if (m.cols() != other.m.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a %lix%li matrix",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.m.rows()), static_cast<long>(other.m.cols()));
+
+        std::unique_ptr<MatrixX> result(new MatrixX(m.rows(), other.m.cols()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.nonZeros() * other.m.cols(),
+                [&]() { result->m.noalias() = m * other.m; });
+        return result.release();
+    }
+
+    double norm() const { return m.norm(); }
+
+    bool isApprox(SparseMatrix const& other, double tolerance) const
+    { return m.isApprox(other.m, tolerance); }
+};
+
+/*
+ * Document-class: Eigen::SimplicialLDLT
+ *
+ * Sparse Cholesky factorization of a symmetric positive definite matrix. Only
+ * the lower triangular part of the matrix is used.
+ *
+ * The symbolic analysis only depends on the sparsity pattern. When solving a
+ * sequence of systems whose matrices share the same pattern, call
+ * {#analyze_pattern} once and then {#factorize} for each matrix.
+ *
+ * @!method initialize
+ *   Creates an empty factorization. Call {#compute}, or {#analyze_pattern}
+ *   and {#factorize}, before using it.
+ * @!method analyze_pattern(matrix)
+ *   Computes the symbolic analysis of the matrix' sparsity pattern
+ *   @param [SparseMatrix] matrix
+ *   @return [void]
+ * @!method factorize(matrix)
+ *   Computes the numerical factorization of a matrix, reusing the last
+ *   symbolic analysis
+ *   @param [SparseMatrix] matrix a matrix with the same sparsity pattern
+ *     than the one given to {#analyze_pattern}
+ *   @return [void]
+ * @!method compute(matrix)
+ *   Analyzes and factorizes a matrix
+ *   @param [SparseMatrix] matrix
+ *   @return [void]
+ * @!method solve(rhs, out = nil)
+ *   Solves matrix * x = rhs
+ *   @param [VectorX,MatrixX] rhs
+ *   @param [VectorX,MatrixX,nil] out if given, the result is written into
+ *     it instead of a new object
+ *   @return [VectorX,MatrixX] x, of the same type than rhs
+ * @!method success?
+ *   Whether the last factorization succeeded
+ *   @return [Boolean]
+ * @!method determinant
+ *   The determinant of the factorized matrix
+ *   @return [Float]
+ */
+
+/*
+ * Document-class: Eigen::SparseLU
+ *
+ * Sparse LU factorization with partial pivoting of a square matrix. It has
+ * the same API than {Eigen::SimplicialLDLT}
+ */
+
+/*
+ * Document-class: Eigen::ConjugateGradient
+ *
+ * Iterative solver for symmetric positive definite matrices, with a
+ * diagonal preconditioner. Both triangular parts of the matrix are used.
+ *
+ * It has the same API than {Eigen::SimplicialLDLT}. {#success?} tells
+ * whether the last {#solve} converged.
+ *
+ * @!method tolerance
+ *   The relative residual error below which the iterations stop
+ *   @return [Float]
+ * @!method tolerance=(value)
+ *   @param [Float] value
+ * @!method max_iterations
+ *   The maximum number of iterations, by default twice the matrix size
+ *   @return [Integer]
+ * @!method max_iterations=(count)
+ *   @param [Integer] count
+ * @!method iterations
+ *   The number of iterations of the last {#solve}
+ *   @return [Integer]
+ * @!method error
+ *   The estimated relative residual error of the last {#solve}
+ *   @return [Float]
+ */
+template<typename Solver>
+struct SparseSolver : NoGVLUsage
+{
+    Solver d;
+    bool analyzed;
+    bool computed;
+    bool factorization_ok;
+    long pattern_rows;
+    long pattern_nonzeros;
+
+    // Iterative solvers reference the matrix given to analyzePattern and
+    // factorize instead of copying it. They get a copy owned by the
+    // wrapper, so that the Ruby object can be modified or collected
+    static const bool references_matrix =
+        std::is_base_of<Eigen::IterativeSolverBase<Solver>, Solver>::value;
+    SparseMatrix::EigenType matrix_copy;
+
+    /* The matrix to pass to the solver, to be called with the GVL held */
+    SparseMatrix::EigenType const& solverInput(SparseMatrix const& matrix)
+    {
+        if (!references_matrix)
+            return matrix.m;
+        matrix_copy = matrix.m;
+        return matrix_copy;
+    }
+
+    SparseSolver()
+        : analyzed(false), computed(false), factorization_ok(false)
+        , pattern_rows(0), pattern_nonzeros(0) {}
+
+    static void checkSquare(SparseMatrix const& matrix)
+    {
+        if (matrix.m.rows() != matrix.m.cols())
+            throw Exception(rb_eArgError, "expected a square matrix, got %lix%li",
+                    static_cast<long>(matrix.m.rows()), static_cast<long>(matrix.m.cols()));
+    }
+
+    void analyzePattern(SparseMatrix const& matrix)
+    {
+        checkWritable();
+        checkSquare(matrix);
+        analyzed = computed = false;
+        SparseMatrix::EigenType const& input = solverInput(matrix);
+        NoGVLGuard guard_matrix(matrix), guard_self(*this, true);
+        computeWithoutGVL(matrix.m.nonZeros() * 16, [&]() { d.analyzePattern(input); });
+        pattern_rows = matrix.m.rows();
+        pattern_nonzeros = matrix.m.nonZeros();
+        analyzed = true;
+    }
+
+    void factorize(SparseMatrix const& matrix)
+    {
+        checkWritable();
+        if (!analyzed)
+            throw Exception(rb_eRuntimeError, "the pattern has not been analyzed, call #analyze_pattern or #compute first");
+        // Eigen does not check that the pattern is the same, this catches
+        // the obvious mismatches
+        if (matrix.m.rows() != pattern_rows || matrix.m.nonZeros() != pattern_nonzeros)
+            throw Exception(rb_eArgError, "expected a %lix%li matrix with %li non-zeros, as given to #analyze_pattern, got %lix%li with %li",
+                    pattern_rows, pattern_rows, pattern_nonzeros,
+                    static_cast<long>(matrix.m.rows()), static_cast<long>(matrix.m.cols()),
+                    static_cast<long>(matrix.m.nonZeros()));
+
+        computed = false;
+        SparseMatrix::EigenType const& input = solverInput(matrix);
+        NoGVLGuard guard_matrix(matrix), guard_self(*this, true);
+        computeWithoutGVL(matrix.m.nonZeros() * 16, [&]() { d.factorize(input); });
+        computed = true;
+        factorization_ok = (d.info() == Eigen::Success);
+    }
+
+    void compute(SparseMatrix const& matrix)
+    {
+        analyzePattern(matrix);
+        factorize(matrix);
+    }
+
+    void checkComputed() const
+    {
+        if (!computed)
+            throw Exception(rb_eRuntimeError, "the factorization has not been computed");
+    }
+
+    /* SparseLU cannot be used after failing, e.g. on a singular matrix */
+    void checkFactorizationOk() const
+    {
+        checkComputed();
+        if (!factorization_ok)
+            throw Exception(rb_eRuntimeError, "the factorization failed, see #success?");
+    }
+
+    Object solve(Object rhs, Object out) const
+    {
+        checkFactorizationOk();
+        return solveWith(d, *this, rhs, out);
+    }
+
+    bool success() const
+    {
+        checkComputed();
+        return d.info() == Eigen::Success;
+    }
+
+    double determinant() const
+    {
+        checkFactorizationOk();
+        // SparseLU::determinant is not const, although it does not modify
+        // the decomposition
+        return const_cast<Solver&>(d).determinant();
+    }
 
-    Matrix4* scale(double value) const
-    { return new Matrix4(*mx * value); }
+    double tolerance() const { return d.tolerance(); }
+    void setTolerance(double value)
+    {
+        checkWritable();
+        if (value <= 0)
+            throw Exception(rb_eArgError, "the tolerance must be strictly positive");
+        d.setTolerance(value);
+    }
 
-    Matrix4* dotM (Matrix4 const& other) const
-    { return new Matrix4(*mx * (*other.mx)); }
+    int maxIterations() const { return d.maxIterations(); }
+    void setMaxIterations(int count)
+    {
+        checkWritable();
+        if (count <= 0)
+            throw Exception(rb_eArgError, "the maximum number of iterations must be strictly positive");
+        d.setMaxIterations(count);
+    }
 
-    bool operator ==(Matrix4 const& other) const
-    { return (*this->mx) == (*other.mx); }
+    int iterations() const
+    {
+        checkComputed();
+        return d.iterations();
+    }
 
-    bool isApprox(Matrix4 const& other, double tolerance)
-    { return mx->isApprox(*other.mx, tolerance); }
+    double error() const
+    {
+        checkComputed();
+        return d.error();
+    }
 };
 
-/* 
- * Document-class: Eigen::JacobiSVD
+typedef SparseSolver< Eigen::SimplicialLDLT<SparseMatrix::EigenType> > SimplicialLDLT;
+typedef SparseSolver< Eigen::SparseLU<SparseMatrix::EigenType> > SparseLU;
+typedef SparseSolver< Eigen::ConjugateGradient<SparseMatrix::EigenType, Eigen::Lower | Eigen::Upper> > ConjugateGradient;
+
+/*
+ * Document-class: Eigen::MappedMatrixX
  *
- * Linear problem solver
+ * A matrix of doubles stored in a memory-mapped file, in column-major order
+ * and native byte order. Pages are loaded on demand by the system, so the
+ * file can be much larger than the available memory.
  *
- * This is not constructed directly. Use {Eigen::MatrixX#jacobiSvd} instead.
+ * Matrices are created with {Eigen::MatrixX.mmap}. In read-write mode,
+ * modifications are written back to the file.
  *
- * @!method solve(vector)
- *   Solves the linear problem for a given vector
- *   @param [VectorX] vector
- *   @return [VectorX] the result
- */
-struct JacobiSVD {
-    typedef Eigen::JacobiSVD<Eigen::MatrixXd::PlainObject> EigenT;
-    EigenT* j;
-
-    JacobiSVD( EigenT const& j )
-    : j(new EigenT(j)) {}
-    JacobiSVD( JacobiSVD const& j )
-    : j(new EigenT(*j.j)) {}
-    ~JacobiSVD()
-    { delete j; }
-
-    VectorX* solve(VectorX* y)
-    { return new VectorX(j->solve(*y->v)); }
-};
-
-/* 
- * Document-class: Eigen::MatrixX
+ * The computations release the GVL when the matrix is large enough. Methods
+ * that return a matrix or a vector return a new {Eigen::MatrixX} or
+ * {Eigen::VectorX}.
  *
- * A variable-size matrix holding floating-point numbers
+ * Only the methods listed below are available. Unlike the block views, a
+ * mapped matrix is not a {Eigen::MatrixX} operand: it cannot be passed to the
+ * MatrixX methods (e.g. MatrixX#dotM raises TypeError), and has no
+ * arithmetic operators, reductions, coefficient-wise methods, blocks or
+ * mul_into!. Use {#to_matrix} to load it, or its memory view, for these.
  *
- * @!method resize(rows, cols)
- *    Resizes the matrix
- *    @param [Integer] rows the new number of rows
- *    @param [Integer] cols the new number of columns
+ * @!method mapped?
+ *    Whether the file is still mapped, i.e. {#close} has not been called
+ *    @return [Boolean]
+ * @!method writable?
+ *    Whether the file was mapped in read-write mode
+ *    @return [Boolean]
+ * @!method close
+ *    Unmaps the file. Using the matrix afterwards raises IOError
+ *    @return [void]
+ * @!method sync
+ *    Writes the modified pages back to the file and waits for completion
+ *    @return [void]
  * @!method rows
  *    @return [Integer] the number of rows
  * @!method cols
- *    @return [Numeric] the number of columns
+ *    @return [Integer] the number of columns
  * @!method size
- *    @return [Numeric] the number of elements
+ *    @return [Integer] the number of elements
  * @!method [](row, col)
  *    Accesses an element
- *    @param [Integer] row the element's row
- *    @param [Integer] col the element's column
- *    @return [Numeric] the required element
+ *    @return [Float]
  * @!method []=(row, col, value)
- *    Sets an element
- *    @param [Integer] row the element's row
- *    @param [Integer] col the element's column
- *    @param [Numeric] value the new value
- *    @return [Numeric] the value
- * @!method setRow(row, vector)
- *    Sets a whole matrix row
- *    @param [Integer] row the row index
- *    @param [VectorX] vector the row values
- * @!method setColumn(column, vector)
- *    Sets a whole matrix column
- *    @param [Integer] row the column index
- *    @param [VectorX] vector the column values
- * @!method +(m)
- *    Sums two matrices
- *    @param [MatrixX] m the matrix to add
- *    @return [MatrixX] the sum
- * @!method -(m)
- *    Subtracts two matrices
- *    @param [MatrixX] m the matrix to subtract to self
- *    @return [MatrixX] the subtraction
- * @!method *(v)
- *    Multiplies by a scalar
- *    @param [Numeric] v the scalar
- *    @return [MatrixX] the result
- * @!method /(v)
- *    Divides this matrix by a scalar
- *    @param [Numeric] v the scalar
- *    @return [MatrixX] the result
- * @!method -@(v)
- *    Returns this matrix' negation
- *    @return [MatrixX] the result
- * @!method T
- *    Returns the transposed matrix
+ *    Sets an element. Raises IOError if the file is mapped read-only
+ *    @return [Float]
+ * @!method to_a(column_major = true)
+ *    @return [Array<Float>] the values flattened in a ruby array
+ * @!method to_matrix
+ *    Loads the whole matrix in memory
  *    @return [MatrixX]
+ * @!method replace(m)
+ *    Copies the values of a matrix of the same size into the file
+ *    @param [MatrixX] m
+ *    @return [void]
+ * @!method T
+ *    @return [MatrixX] the transposed matrix
  * @!method norm
- *    Returns the matrix' norm
- *    @return [Numeric]
- * @!method dotV(m)
- *    Matrix/vector multiplication
- *    @param [VectorX]
- *    @return [Numeric]
+ *    @return [Float] the Frobenius norm
+ * @!method dotV(v)
+ *    @param [VectorX] v
+ *    @return [VectorX] the matrix-vector product
  * @!method dotM(m)
- *    Matrix multiplication
- *    @param [Matrix4]
- *    @return [Numeric]
- * @!method approx?(m, threshold = dummy_precision)
- *    Verifies that two matrices are within threshold of each other, elementwise
- *    @param [Matrix4]
+ *    @param [MatrixX] m
+ *    @return [MatrixX] the matrix product
+ * @!method approx?(m, tolerance = dummy_precision)
+ *    @param [MatrixX] m
  *    @return [Boolean]
  * @!method jacobiSvd(flags = 0)
- *    Returns a SVD solver to find V from W in self.dotV(V) = W
- *    @param [Integer] flags solver flags, as OR-ed values of Eigen::ComputeFullU,
- *      Eigen::ComputeThinU and Eigen::ComputeThinV. See Eigen documentation
- *    @return [JacobiSVD]
+ *    @return [JacobiSVD] see {Eigen::MatrixX#jacobiSvd}
+ * @!method bdcSvd(flags = 0)
+ *    @return [BDCSVD] see {Eigen::MatrixX#bdcSvd}
+ * @!method llt
+ *    @return [LLT] see {Eigen::MatrixX#llt}
+ * @!method ldlt
+ *    @return [LDLT] see {Eigen::MatrixX#ldlt}
+ * @!method lu
+ *    @return [PartialPivLU] see {Eigen::MatrixX#lu}
+ * @!method qr
+ *    @return [ColPivHouseholderQR] see {Eigen::MatrixX#qr}
+ *
+ * The matrix exports a column-major memory view of the mapping, read-only
+ * if the file was mapped read-only.
  */
-struct MatrixX {
+struct MappedMatrixX : NoGVLUsage
+{
+    typedef Eigen::Map< EigenMatrixX<double> > MapType;
+
+    void* address;
+    size_t length;
+    long map_rows, map_cols;
+    bool writable;
+    bool closed;
+
+    MappedMatrixX()
+        : address(nullptr), length(0), map_rows(0), map_cols(0)
+        , writable(false), closed(false) {}
+    ~MappedMatrixX() { unmap(); }
+
+    void unmap()
+    {
+        if (address)
+            munmap(address, length);
+        address = nullptr;
+        length = 0;
+    }
+
+    /* Maps the first rows * cols doubles of an open file
+     *
+     * The file size is checked by MatrixX.mmap. The file descriptor can be
+     * closed afterwards.
+     */
+    void mapFile(int fd, long rows, long cols, bool writable)
+    {
+        checkWritable();
+        if (rows < 0 || cols < 0)
+            throw Exception(rb_eArgError, "invalid matrix size %lix%li", rows, cols);
+
+        unmap();
+        map_rows = rows;
+        map_cols = cols;
+        this->writable = writable;
+        closed = false;
+
+        size_t size = static_cast<size_t>(rows) * cols * sizeof(double);
+        if (size == 0)
+            return;
+
+        int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+        void* result = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        if (result == MAP_FAILED)
+            throw Exception(rb_eIOError, "cannot map the file: %s", strerror(errno));
+        address = result;
+        length = size;
+    }
 
-    MatrixXd* m;
+    bool isMapped() const { return !closed; }
+    bool isWritable() const { return writable; }
 
-    MatrixX() : m(new MatrixXd()) {}
-    MatrixX(const MatrixX& m) : m(new MatrixXd(*m.m)) {}
-    MatrixX(int rows, int cols) : m(new MatrixXd(rows,cols)) {}
-    MatrixX(const MatrixXd& _m) : m(new MatrixXd(_m)) {}
-    ~MatrixX() { delete m; }
+    void close()
+    {
+        checkWritable();
+        unmap();
+        map_rows = map_cols = 0;
+        closed = true;
+    }
 
-    void resize(int rows, int cols) { m->resize(rows,cols); }
-    void conservativeResize(int rows, int cols) { m->conservativeResize(rows,cols); }
+    void sync()
+    {
+        checkOpen();
+        if (address && msync(address, length, MS_SYNC) != 0)
+            throw Exception(rb_eIOError, "cannot sync the file: %s", strerror(errno));
+    }
 
-    double norm() const { return m->norm(); }
+    void checkOpen() const
+    {
+        if (closed)
+            throw Exception(rb_eIOError, "the matrix has been unmapped");
+    }
 
-    unsigned int rows() const { return m->rows(); }
-    unsigned int cols() const { return m->cols(); }
-    unsigned int size() const { return m->size(); }
+    void checkWritableFile() const
+    {
+        checkOpen();
+        if (!writable)
+            throw Exception(rb_eIOError, "the matrix is mapped read-only");
+        checkWritable();
+    }
 
-    double get(int i, int j ) const { return (*m)(i,j); }
-    void set(int i, int j, double value) { (*m)(i,j) = value; }
-    
-    VectorX* getRow(int i) const { return new VectorX(m->row(i)); }
-    void setRow(int i, const VectorX& v) { m->row(i) = *(v.v); }
+    MapType map() const
+    {
+        checkOpen();
+        checkReadable();
+        return MapType(static_cast<double*>(address), map_rows, map_cols);
+    }
 
-    VectorX* getColumn(int j) const { return new VectorX(m->col(j)); }
-    void setColumn(int j, const VectorX& v) { m->col(j) = *(v.v); }
+    long rows() const { checkOpen(); return map_rows; }
+    long cols() const { checkOpen(); return map_cols; }
+    long size() const { checkOpen(); return map_rows * map_cols; }
 
-    MatrixX* transpose() const
-    { return new MatrixX(m->transpose()); }
+    void checkIndex(int i, int j) const
+    {
+        if (i < 0 || i >= map_rows || j < 0 || j >= map_cols)
+            throw Exception(rb_eIndexError, "(%i, %i) out of bounds of a %lix%li matrix",
+                    i, j, map_rows, map_cols);
+    }
+
+    double get(int i, int j) const
+    {
+        checkOpen();
+        checkIndex(i, j);
+        return map()(i, j);
+    }
+    void set(int i, int j, double value)
+    {
+        checkWritableFile();
+        checkIndex(i, j);
+        map()(i, j) = value;
+    }
 
-    MatrixX* operator + (MatrixX const& other) const
-    { return new MatrixX(*m + *other.m); }
+    Array toArray(bool column_major) const
+    { return ::toArray(map(), column_major); }
 
-    MatrixX* operator - (MatrixX const& other) const
-    { return new MatrixX(*m - *other.m); }
+    MatrixX* toMatrix() const
+    {
+        MapType m = map();
+        std::unique_ptr<MatrixX> result(new MatrixX());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(m.size(), [&]() { result->m = m; });
+        return result.release();
+    }
 
-    MatrixX* operator / (double scalar) const
-    { return new MatrixX(*m / scalar); }
+    void replace(MatrixX const& other)
+    {
+        checkWritableFile();
+        MapType m = map();
+        checkSameSize(m, other.m);
+        NoGVLGuard guard_other(other), guard_self(*this, true);
+        computeWithoutGVL(m.size(), [&]() { m = other.m; });
+    }
 
-    MatrixX* negate() const
-    { return new MatrixX(-*m); }
-    
-    MatrixX* scale (double scalar) const
-    { return new MatrixX(*m * scalar); }
+    MatrixX* transpose() const
+    {
+        MapType m = map();
+        std::unique_ptr<MatrixX> result(new MatrixX());
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(m.size(), [&]() { result->m = m.transpose(); });
+        return result.release();
+    }
 
-    VectorX* dotV (VectorX const& other) const
-    { return new VectorX(*m * *other.v); }
-    
-    MatrixX* dotM (MatrixX const& other) const
-    { return new MatrixX(*m * (*other.m)); }
+    double norm() const
+    {
+        MapType m = map();
+        double result;
+        NoGVLGuard guard(*this);
+        computeWithoutGVL(m.size(), [&]() { result = m.norm(); });
+        return result;
+    }
 
-    JacobiSVD* jacobiSvd(int flags = 0) const
-    { return new JacobiSVD(m->jacobiSvd(flags)); }
+    VectorX* dotV(VectorX const& other) const
+    {
+        MapType m = map();
+        if (m.cols() != other.v.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a vector of size %li",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.v.rows()));
+
+        std::unique_ptr<VectorX> result(new VectorX(m.rows()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.size(), [&]() { result->v.noalias() = m * other.v; });
+        return result.release();
+    }
 
-    bool operator ==(MatrixX const& other) const
-    { return (*this->m) == (*other.m); }
+    MatrixX* dotM(MatrixX const& other) const
+    {
+        MapType m = map();
+        if (m.cols() != other.m.rows())
+            throw Exception(rb_eArgError, "cannot multiply a %lix%li matrix by a %lix%li matrix",
+                    static_cast<long>(m.rows()), static_cast<long>(m.cols()),
+                    static_cast<long>(other.m.rows()), static_cast<long>(other.m.cols()));
+
+        std::unique_ptr<MatrixX> result(new MatrixX(m.rows(), other.m.cols()));
+        NoGVLGuard guard_self(*this), guard_other(other);
+        computeWithoutGVL(m.size() * other.m.cols(),
+                [&]() { result->m.noalias() = m * other.m; });
+        return result.release();
+    }
 
-    bool isApprox(MatrixX const& other, double tolerance)
-    { return m->isApprox(*other.m, tolerance); }
+    bool isApprox(MatrixX const& other, double tolerance) const
+    { return map().isApprox(other.m, tolerance); }
+
+    JacobiSVD* jacobiSvd(int flags) const
+    { return decompose< Eigen::JacobiSVD<Eigen::MatrixXd> >(map(), *this, flags); }
+    BDCSVD* bdcSvd(int flags) const
+    { return decompose< Eigen::BDCSVD<Eigen::MatrixXd> >(map(), *this, flags); }
+    LLT* llt() const
+    { return factorize< Eigen::LLT<Eigen::MatrixXd> >(map(), *this); }
+    LDLT* ldlt() const
+    { return factorize< Eigen::LDLT<Eigen::MatrixXd> >(map(), *this); }
+    PartialPivLU* lu() const
+    { return factorize< Eigen::PartialPivLU<Eigen::MatrixXd> >(map(), *this); }
+    ColPivHouseholderQR* qr() const
+    { return factorize< Eigen::ColPivHouseholderQR<Eigen::MatrixXd> >(map(), *this); }
 };
 
 /*
@@ -611,94 +4597,120 @@ struct MatrixX {
  *   Initializes from a rotation matrix
  *   @param [MatrixX]
  *   @return [void]
+ * @!method to_binary
+ *   Returns the coefficients as a packed binary string, in Eigen's storage
+ *   order (x, y, z, w)
+ *   @return [String]
+ * @!method from_binary(buffer)
+ *   Sets the coefficients from a string created by {#to_binary}
+ *   @param [String] buffer
+ *   @return [void]
+ * @!method to_single
+ *   Converts to single precision
+ *   @return [Quaternionf]
  */
-struct Quaternion
-{
-    Quaterniond* q;
-    Quaternion(double w, double x, double y, double z)
-        : q(new Quaterniond(w, x, y, z)) { }
-    Quaternion(Quaternion const& q)
-        : q(new Quaterniond(*q.q)) { }
-    Quaternion(Quaterniond const& _q)
-        : q(new Quaterniond(_q)) {}
-
-    ~Quaternion()
-    { delete q; }
-
-    double w() const { return q->w(); }
-    double x() const { return q->x(); }
-    double y() const { return q->y(); }
-    double z() const { return q->z(); }
-    void setW(double value) { q->w() = value; }
-    void setX(double value) { q->x() = value; }
-    void setY(double value) { q->y() = value; }
-    void setZ(double value) { q->z() = value; }
-
-    double norm() const { return q->norm(); }
-
-    bool operator ==(Quaternion const& other) const
+template<typename Scalar>
+struct BasicQuaternion
+{
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    typedef EigenQuaternion<Scalar> EigenType;
+    EigenType q;
+    BasicQuaternion(double w, double x, double y, double z)
+        : q(w, x, y, z) { }
+    BasicQuaternion(BasicQuaternion const& q)
+        : q(q.q) { }
+    BasicQuaternion(EigenType const& _q)
+        : q(_q) {}
+
+    double w() const { return q.w(); }
+    double x() const { return q.x(); }
+    double y() const { return q.y(); }
+    double z() const { return q.z(); }
+    void setW(double value) { q.w() = value; }
+    void setX(double value) { q.x() = value; }
+    void setY(double value) { q.y() = value; }
+    void setZ(double value) { q.z() = value; }
+
+    double norm() const { return q.norm(); }
+
+    String toBinary() const { return ::toBinary(q.coeffs().data(), 4, 1); }
+    void fromBinary(String buffer) { ::fromBinary(buffer, q.coeffs().data(), 4, 1); }
+
+    bool operator ==(BasicQuaternion const& other) const
     { return x() == other.x() && y() == other.y() && z() == other.z() && w() == other.w(); }
 
-    Quaternion* concatenate(Quaternion const& other) const
-    { return new Quaternion((*q) * (*other.q)); }
-    Vector3* transform(Vector3 const& v) const
-    { return new Vector3((*q) * (*v.v)); }
-    Quaternion* inverse() const
-    { return new Quaternion(q->inverse()); }
+    BasicQuaternion* concatenate(BasicQuaternion const& other) const
+    { return new BasicQuaternion(q * other.q); }
+    BasicVector3<Scalar>* transform(BasicVector3<Scalar> const& v) const
+    { return new BasicVector3<Scalar>(q * v.v); }
+    BasicQuaternion* inverse() const
+    { return new BasicQuaternion(q.inverse()); }
     void normalizeBang()
-    { q->normalize(); }
-    Quaternion* normalize() const
-    { 
-        Quaterniond q = *this->q;
-        q.normalize();
-        return new Quaternion(q);
-    }
-    MatrixX* matrix() const
+    { q.normalize(); }
+    BasicQuaternion* normalize() const
+    { return new BasicQuaternion(q.normalized()); }
+    BasicMatrixX<Scalar>* matrix() const
     {
-        return new MatrixX(q->matrix());
+        return new BasicMatrixX<Scalar>(q.matrix());
     }
 
-    void fromAngleAxis(double angle, Vector3 const& axis)
+    void fromAngleAxis(double angle, BasicVector3<Scalar> const& axis)
     {
-	*(this->q) = 
-            Eigen::AngleAxisd(angle, *axis.v);
+        q = Eigen::AngleAxis<Scalar>(angle, axis.v);
     }
 
-    void fromEuler(Vector3 const& angles, int axis0, int axis1, int axis2)
+    void fromEuler(BasicVector3<Scalar> const& angles, int axis0, int axis1, int axis2)
     {
-        *(this->q) =
-            Eigen::AngleAxisd(angles.x(), Eigen::Vector3d::Unit(axis0)) *
-            Eigen::AngleAxisd(angles.y(), Eigen::Vector3d::Unit(axis1)) *
-            Eigen::AngleAxisd(angles.z(), Eigen::Vector3d::Unit(axis2));
+        q =
+            Eigen::AngleAxis<Scalar>(angles.x(), Eigen::Matrix<Scalar, 3, 1>::Unit(axis0)) *
+            Eigen::AngleAxis<Scalar>(angles.y(), Eigen::Matrix<Scalar, 3, 1>::Unit(axis1)) *
+            Eigen::AngleAxis<Scalar>(angles.z(), Eigen::Matrix<Scalar, 3, 1>::Unit(axis2));
     }
 
-    void fromMatrix(MatrixX const& matrix)
+    void fromMatrix(BasicMatrixX<Scalar> const& matrix)
     {
-	*(this->q) = 
-            Quaterniond(Eigen::Matrix3d(*matrix.m));
+        q = EigenType(Eigen::Matrix<Scalar, 3, 3>(matrix.m));
     }
 
-    bool isApprox(Quaternion const& other, double tolerance)
+    bool isApprox(BasicQuaternion const& other, double tolerance)
     {
-        return q->isApprox(*other.q, tolerance);
+        return q.isApprox(other.q, tolerance);
     }
 
-    Vector3* toEuler()
+    BasicVector3<Scalar>* toEuler()
     {
-        const Eigen::Matrix3d m = q->toRotationMatrix();
-        double i = Eigen::Vector2d(m.coeff(2,2) , m.coeff(2,1)).norm();
+        const Eigen::Matrix<Scalar, 3, 3> m = q.toRotationMatrix();
+        double i = Eigen::Matrix<Scalar, 2, 1>(m.coeff(2,2) , m.coeff(2,1)).norm();
         double y = atan2(-m.coeff(2,0), i);
         double x=0,z=0;
-        if (i > Eigen::NumTraits<double>::dummy_precision()){
+        if (i > Eigen::NumTraits<Scalar>::dummy_precision()){
             x = ::atan2(m.coeff(1,0), m.coeff(0,0));
             z = ::atan2(m.coeff(2,1), m.coeff(2,2));
         }else{
             z = (m.coeff(2,0)>0?1:-1)* ::atan2(-m.coeff(0,1), m.coeff(1,1));
         }
-        return new Vector3(x,y,z);
+        return new BasicVector3<Scalar>(x,y,z);
     }
+
+    typedef BasicQuaternion<typename OtherPrecision<Scalar>::type> Converted;
+    Converted* convert() const
+    { return new Converted(q.template cast<typename OtherPrecision<Scalar>::type>()); }
 };
 
+typedef BasicQuaternion<double> Quaternion;
+typedef BasicQuaternion<float> Quaternionf;
+
+/*
+ * Document-class: Eigen::Quaternionf
+ *
+ * Single-precision version of {Eigen::Quaternion}, with the same API.
+ *
+ * @!method to_double
+ *   Converts to double precision
+ *   @return [Quaternion]
+ */
+
 
 /*
  * Document-class: Eigen::AngleAxis
@@ -743,48 +4755,66 @@ struct Quaternion
  * @!method from_matrix(matrix)
  *    Initializes from a rotation matrix
  *    @param [MatrixX]
+ * @!method to_binary
+ *    Returns the angle and axis as a packed binary string, in the (angle, x,
+ *    y, z) order
+ *    @return [String]
+ * @!method from_binary(buffer)
+ *    Sets the angle and axis from a string created by {#to_binary}
+ *    @param [String] buffer
+ *    @return [void]
  */
 struct AngleAxis
 {
-    AngleAxisd* aa;
+    AngleAxisd aa;
     AngleAxis(double angle, Vector3 const& axis)
-        : aa(new AngleAxisd(angle, Eigen::Vector3d(*axis.v))){}
+        : aa(angle, Eigen::Vector3d(axis.v)){}
     AngleAxis(AngleAxis const& aa)
-        : aa(new AngleAxisd(*aa.aa)) { }
+        : aa(aa.aa) { }
     AngleAxis(AngleAxisd const& _aa)
-        : aa(new AngleAxisd(_aa)) {}
-
-    ~AngleAxis()
-    { delete aa; }
+        : aa(_aa) {}
 
     bool operator ==(AngleAxis const& other) const
     { return angle() == other.angle() && axis() == other.axis(); }
 
-    double angle() const { return aa->angle(); }
-    Vector3* axis() const { return new Vector3(aa->axis()); }
+    double angle() const { return aa.angle(); }
+    Vector3* axis() const { return new Vector3(aa.axis()); }
+
+    String toBinary() const
+    {
+        Eigen::Vector4d data(aa.angle(), aa.axis().x(), aa.axis().y(), aa.axis().z());
+        return ::toBinary(data.data(), 4, 1);
+    }
+    void fromBinary(String buffer)
+    {
+        Eigen::Vector4d data;
+        ::fromBinary(buffer, data.data(), 4, 1);
+        aa.angle() = data[0];
+        aa.axis() = data.tail<3>();
+    }
 
     AngleAxis* concatenate(AngleAxis const& other) const
-    { return new AngleAxis(static_cast<AngleAxisd>((*aa) * (*other.aa))); }
+    { return new AngleAxis(static_cast<AngleAxisd>(aa * other.aa)); }
 
     Vector3* transform(Vector3 const& v) const
-    { return new Vector3((*aa) * (*v.v)); }
+    { return new Vector3(aa * v.v); }
 
     AngleAxis* inverse() const
-    { return new AngleAxis(aa->inverse()); }
+    { return new AngleAxis(aa.inverse()); }
 
     MatrixX* matrix() const
     {
-        return new MatrixX(aa->matrix());
+        return new MatrixX(aa.matrix());
     }
 
     void fromQuaternion(Quaternion const& q)
     {
-        *(this->aa) = Eigen::Quaterniond(q.w(), q.x(), q.y(), q.z());
+        aa = Eigen::Quaterniond(q.w(), q.x(), q.y(), q.z());
     }
 
     void fromEuler(Vector3 const& angles, int axis0, int axis1, int axis2)
     {
-        *(this->aa) =
+        aa =
             Eigen::AngleAxisd(angles.x(), Eigen::Vector3d::Unit(axis0)) *
             Eigen::AngleAxisd(angles.y(), Eigen::Vector3d::Unit(axis1)) *
             Eigen::AngleAxisd(angles.z(), Eigen::Vector3d::Unit(axis2));
@@ -792,18 +4822,18 @@ struct AngleAxis
 
     void fromMatrix(MatrixX const& matrix)
     {
-	    *(this->aa) =
-            AngleAxisd(Eigen::Matrix3d(*matrix.m));
+	    aa =
+            AngleAxisd(Eigen::Matrix3d(matrix.m));
     }
 
     bool isApprox(AngleAxis const& other, double tolerance)
     {
-        return aa->isApprox(*other.aa, tolerance);
+        return aa.isApprox(other.aa, tolerance);
     }
 
     Vector3* toEuler()
     {
-        const Eigen::Matrix3d m = aa->toRotationMatrix();
+        const Eigen::Matrix3d m = aa.toRotationMatrix();
         double i = Eigen::Vector2d(m.coeff(2,2) , m.coeff(2,1)).norm();
         double y = atan2(-m.coeff(2,0), i);
         double x=0,z=0;
@@ -860,51 +4890,81 @@ struct AngleAxis
  * @!method matrix
  *    The transformation matrix equivalent to self
  *    @return [MatrixX]
+ * @!method to_binary
+ *    Returns the 4x4 transformation matrix as a packed binary string
+ *    @return [String]
+ * @!method from_binary(buffer)
+ *    Sets the transformation matrix from a string created by {#to_binary}
+ *    @param [String] buffer
+ *    @return [void]
+ * @!method transform_all(points)
+ *    Transforms a list of points. Large lists are split across threads.
+ *    @param [Vector3Array] points
+ *    @return [Vector3Array] the transformed points
+ * @!method transform_all!(points)
+ *    Transforms a list of points in place. Large lists are split across
+ *    threads.
+ *    @param [Vector3Array] points the points, modified by the call
+ *    @return [void]
  */
 struct Isometry3
 {
-    Isometry3d *t;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Isometry3d t;
 
-    Isometry3() : t(new Isometry3d()) { t->setIdentity(); }
-    Isometry3(const Isometry3& _m) : t(new Isometry3d(*_m.t)) {}
-    Isometry3(const Isometry3d& _m) : t(new Isometry3d(_m)) {}
-    ~Isometry3() { delete t; }
+    Isometry3() { t.setIdentity(); }
+    Isometry3(const Isometry3& _m) : t(_m.t) {}
+    Isometry3(const Isometry3d& _m) : t(_m) {}
+
+    String toBinary() const { return ::toBinary(t.data(), 4, 4); }
+    void fromBinary(String buffer) { ::fromBinary(buffer, t.data(), 4, 4); }
 
     Isometry3* inverse() const
-    { return new Isometry3( t->inverse() ); }
+    { return new Isometry3( t.inverse() ); }
 
     Vector3* translation() const
-    { return new Vector3( t->translation() ); }
+    { return new Vector3( t.translation() ); }
 
     Quaternion* rotation() const
-    { return new Quaternion( Eigen::Quaterniond(t->linear()) ); }
+    { return new Quaternion( Eigen::Quaterniond(t.linear()) ); }
 
     Isometry3* concatenate(Isometry3 const& other) const
-    { return new Isometry3( *t * *other.t ); }
+    { return new Isometry3( t * other.t ); }
 
     Vector3* transform(Vector3 const& other) const
-    { return new Vector3( *t * *other.v ); }
+    { return new Vector3( t * other.v ); }
+
+    Vector3Array* transformAll(Vector3Array const& points) const
+    {
+        std::unique_ptr<Vector3Array> result(new Vector3Array(0));
+        points.transform(t, *result);
+        return result.release();
+    }
+
+    void transformAllBang(Vector3Array& points) const
+    { points.transform(t, points); }
 
     MatrixX* matrix() const
-    { return new MatrixX( t->matrix() ); }
+    { return new MatrixX( t.matrix() ); }
 
-    void translate( Vector3 const& other ) const
-    { t->translate( *other.v ); }
+    void translate( Vector3 const& other )
+    { t.translate( other.v ); }
 
-    void pretranslate( Vector3 const& other ) const
-    { t->pretranslate( *other.v ); }
+    void pretranslate( Vector3 const& other )
+    { t.pretranslate( other.v ); }
 
-    void rotate( Quaternion const& other ) const
-    { t->rotate( *other.q ); }
+    void rotate( Quaternion const& other )
+    { t.rotate( other.q ); }
 
-    void prerotate( Quaternion const& other ) const
-    { t->prerotate( *other.q ); }
+    void prerotate( Quaternion const& other )
+    { t.prerotate( other.q ); }
 
     bool operator ==(Isometry3 const& other) const
-    { return (*this->t).matrix() == (*other.t).matrix(); }
+    { return t.matrix() == other.t.matrix(); }
 
     bool isApprox(Isometry3 const& other, double tolerance)
-    { return t->isApprox(*other.t, tolerance); }
+    { return t.isApprox(other.t, tolerance); }
 };
 
 
@@ -949,111 +5009,613 @@ struct Isometry3
  * @!method matrix
  *    The transformation matrix equivalent to self
  *    @return [MatrixX]
+ * @!method to_binary
+ *    Returns the 4x4 transformation matrix as a packed binary string
+ *    @return [String]
+ * @!method from_binary(buffer)
+ *    Sets the transformation matrix from a string created by {#to_binary}
+ *    @param [String] buffer
+ *    @return [void]
+ * @!method transform_all(points)
+ *    Transforms a list of points. Large lists are split across threads.
+ *    @param [Vector3Array] points
+ *    @return [Vector3Array] the transformed points
+ * @!method transform_all!(points)
+ *    Transforms a list of points in place. Large lists are split across
+ *    threads.
+ *    @param [Vector3Array] points the points, modified by the call
+ *    @return [void]
  */
 struct Affine3
 {
-    Affine3d *t;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Affine3d t;
 
-    Affine3() : t(new Affine3d()) { t->setIdentity(); }
-    Affine3(const Affine3& _m) : t(new Affine3d(*_m.t)) {}
-    Affine3(const Affine3d& _m) : t(new Affine3d(_m)) {}
-    ~Affine3() { delete t; }
+    Affine3() { t.setIdentity(); }
+    Affine3(const Affine3& _m) : t(_m.t) {}
+    Affine3(const Affine3d& _m) : t(_m) {}
+
+    String toBinary() const { return ::toBinary(t.data(), 4, 4); }
+    void fromBinary(String buffer) { ::fromBinary(buffer, t.data(), 4, 4); }
 
     Affine3* inverse() const
-    { return new Affine3( t->inverse() ); }
+    { return new Affine3( t.inverse() ); }
 
     Vector3* translation() const
-    { return new Vector3( t->translation() ); }
+    { return new Vector3( t.translation() ); }
 
     Quaternion* rotation() const
-    { return new Quaternion( Eigen::Quaterniond(t->linear()) ); }
+    { return new Quaternion( Eigen::Quaterniond(t.linear()) ); }
 
     Affine3* concatenate(Affine3 const& other) const
-    { return new Affine3( *t * *other.t ); }
+    { return new Affine3( t * other.t ); }
 
     Vector3* transform(Vector3 const& other) const
-    { return new Vector3( *t * *other.v ); }
+    { return new Vector3( t * other.v ); }
+
+    Vector3Array* transformAll(Vector3Array const& points) const
+    {
+        std::unique_ptr<Vector3Array> result(new Vector3Array(0));
+        points.transform(t, *result);
+        return result.release();
+    }
+
+    void transformAllBang(Vector3Array& points) const
+    { points.transform(t, points); }
 
     MatrixX* matrix() const
-    { return new MatrixX( t->matrix() ); }
+    { return new MatrixX( t.matrix() ); }
 
-    void translate( Vector3 const& other ) const
-    { t->translate( *other.v ); }
+    void translate( Vector3 const& other )
+    { t.translate( other.v ); }
 
-    void pretranslate( Vector3 const& other ) const
-    { t->pretranslate( *other.v ); }
+    void pretranslate( Vector3 const& other )
+    { t.pretranslate( other.v ); }
 
-    void rotate( Quaternion const& other ) const
-    { t->rotate( *other.q ); }
+    void rotate( Quaternion const& other )
+    { t.rotate( other.q ); }
 
-    void prerotate( Quaternion const& other ) const
-    { t->prerotate( *other.q ); }
+    void prerotate( Quaternion const& other )
+    { t.prerotate( other.q ); }
 
     bool operator ==(Affine3 const& other) const
-    { return (*this->t).matrix() == (*other.t).matrix(); }
+    { return t.matrix() == other.t.matrix(); }
 
     bool isApprox(Affine3 const& other, double tolerance)
-    { return t->isApprox(*other.t, tolerance); }
+    { return t.isApprox(other.t, tolerance); }
+};
+
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+/* Layout of an exported memory view. It is owned by the view, as the shape
+ * and strides must remain valid until the view is released */
+struct MemoryViewLayout
+{
+    NoGVLUsage const* owner;
+    void* data;
+    char const* format;
+    ssize_t item_size;
+    ssize_t ndim;
+    ssize_t shape[2];
+    ssize_t strides[2];
+    bool readonly;
 };
 
+template<typename Scalar> static char const* memoryViewFormat();
+template<> char const* memoryViewFormat<double>() { return "d"; }
+template<> char const* memoryViewFormat<float>() { return "f"; }
+
+/* Describes a column-major block of coefficients */
+template<typename Scalar>
+static void describeMemory(MemoryViewLayout& layout, NoGVLUsage const& owner,
+        Scalar* data, long rows, long cols, int ndim, bool readonly)
+{
+    layout.owner = &owner;
+    layout.data = data;
+    layout.format = memoryViewFormat<Scalar>();
+    layout.item_size = sizeof(Scalar);
+    layout.ndim = ndim;
+    layout.shape[0] = rows;
+    layout.shape[1] = cols;
+    layout.strides[0] = sizeof(Scalar);
+    layout.strides[1] = sizeof(Scalar) * rows;
+    layout.readonly = readonly;
+}
+
+template<typename Scalar>
+static void describeMemory(MemoryViewLayout& layout, BasicMatrixX<Scalar> const& m)
+{ describeMemory(layout, m, const_cast<Scalar*>(m.m.data()), m.m.rows(), m.m.cols(), 2, false); }
+template<typename Scalar>
+static void describeMemory(MemoryViewLayout& layout, BasicVectorX<Scalar> const& v)
+{ describeMemory(layout, v, const_cast<Scalar*>(v.v.data()), v.v.size(), 1, 1, false); }
+static void describeMemory(MemoryViewLayout& layout, MappedMatrixX const& m)
+{ describeMemory(layout, m, static_cast<double*>(m.address), m.map_rows, m.map_cols, 2, !m.writable); }
+static void describeMemory(MemoryViewLayout& layout, Vector3Array const& a)
+{
+    // Exported as a Nx3 row-major array, i.e. one vector per row
+    describeMemory(layout, a, const_cast<double*>(a.points.data()), 3, a.points.cols(), 2, false);
+    std::swap(layout.shape[0], layout.shape[1]);
+    std::swap(layout.strides[0], layout.strides[1]);
+}
+
+/* Whether a view satisfies the contiguity requested by flags */
+static bool isContiguityAccepted(rb_memory_view_t const* view, int flags)
+{
+    bool row_major = rb_memory_view_is_row_major_contiguous(view);
+    bool column_major = rb_memory_view_is_column_major_contiguous(view);
+    if ((flags & RUBY_MEMORY_VIEW_ANY_CONTIGUOUS) == RUBY_MEMORY_VIEW_ANY_CONTIGUOUS)
+        return row_major || column_major;
+    else if ((flags & RUBY_MEMORY_VIEW_ROW_MAJOR) == RUBY_MEMORY_VIEW_ROW_MAJOR)
+        return row_major;
+    else if ((flags & RUBY_MEMORY_VIEW_COLUMN_MAJOR) == RUBY_MEMORY_VIEW_COLUMN_MAJOR)
+        return column_major;
+    return true;
+}
+
+/* rb_memory_view_entry_t::get_func, this is called from C so it must not
+ * throw */
+template<typename Wrapper>
+static bool getMemoryView(VALUE obj, rb_memory_view_t* view, int flags)
+{
+    try
+    {
+        std::unique_ptr<MemoryViewLayout> layout(new MemoryViewLayout());
+        describeMemory(*layout, *Data_Type<Wrapper>::from_ruby(obj));
+        // Computations without the GVL must not see the memory change
+        // under them, nor be seen mid-write
+        if (layout->owner->no_gvl_users)
+            return false;
+        if (layout->readonly && (flags & RUBY_MEMORY_VIEW_WRITABLE))
+            return false;
+
+        ssize_t count = layout->shape[0] * (layout->ndim == 2 ? layout->shape[1] : 1);
+        view->obj = obj;
+        view->data = layout->data;
+        view->byte_size = count * layout->item_size;
+        view->readonly = layout->readonly;
+        view->format = layout->format;
+        view->item_size = layout->item_size;
+        view->item_desc.components = nullptr;
+        view->item_desc.length = 0;
+        view->ndim = layout->ndim;
+        view->shape = layout->shape;
+        view->strides = layout->strides;
+        view->sub_offsets = nullptr;
+        view->private_data = layout.get();
+        if (!isContiguityAccepted(view, flags))
+            return false;
+
+        ++layout->owner->exported_views;
+        layout.release();
+        return true;
+    }
+    catch(...) { return false; }
+}
+
+static bool releaseMemoryView(VALUE /* obj */, rb_memory_view_t* view)
+{
+    MemoryViewLayout* layout = static_cast<MemoryViewLayout*>(view->private_data);
+    --layout->owner->exported_views;
+    delete layout;
+    return true;
+}
+
+static bool isMemoryViewAvailable(VALUE /* obj */) { return true; }
+
+template<typename Wrapper>
+static void registerMemoryView(Data_Type<Wrapper> const& klass)
+{
+    static rb_memory_view_entry_t const entry = {
+        &getMemoryView<Wrapper>, &releaseMemoryView, &isMemoryViewAvailable
+    };
+    rb_memory_view_register(klass.value(), &entry);
+}
+#endif
+
+/*
+ * Document-method: Eigen.__reported_memsize__
+ *
+ * The total payload size currently reported to Ruby's GC by the
+ * instrumentation. See Eigen.stats
+ *
+ * @return [Integer]
+ */
+static long getReportedMemsize(Object /* self */)
+{ return total_reported_memsize; }
+
+/*
+ * Document-method: Eigen.threads
+ *
+ * The maximum number of threads used by a single computation
+ *
+ * @return [Integer]
+ */
+static int getThreads(Object /* self */)
+{ return max_threads; }
+
+/*
+ * Document-method: Eigen.threads=
+ *
+ * Sets the maximum number of threads used by a single computation
+ *
+ * Eigen's own kernels (e.g. MatrixX#dotM) only use more than one thread if
+ * the extension has been built with OpenMP, see {Eigen.openmp?}
+ *
+ * @param [Integer] count
+ * @return [void]
+ */
+static void setThreads(Object /* self */, int count)
+{
+    if (count < 1)
+        throw Exception(rb_eArgError, "thread count must be at least 1, got %i", count);
+    max_threads = count;
+    Eigen::setNbThreads(count);
+}
+
+/*
+ * Document-method: Eigen.aligned?
+ *
+ * Whether the extension has been built with --enable-aligned, i.e. whether
+ * the fixed-size types use Eigen's aligned storage
+ *
+ * @return [Boolean]
+ */
+static bool isAligned(Object /* self */)
+{
+#ifdef EIGEN_RUBY_ALIGNED
+    return true;
+#else
+    return false;
+#endif
+}
+
+/* The alignment of the fixed-size storage, in bytes */
+static int getFixedAlignment(Object /* self */)
+{ return alignof(Matrix4d); }
+
+/*
+ * Document-method: Eigen.openmp?
+ *
+ * Whether the extension has been built with OpenMP, i.e. whether Eigen's own
+ * kernels can use more than one thread
+ *
+ * @return [Boolean]
+ */
+static bool isOpenMP(Object /* self */)
+{
+#ifdef _OPENMP
+    return true;
+#else
+    return false;
+#endif
+}
+
+/* The number of threads Eigen's own kernels use, always 1 without OpenMP */
+static int getEigenThreads(Object /* self */)
+{ return Eigen::nbThreads(); }
+
+template<typename Scalar>
+static Data_Type< BasicVector3<Scalar> > defineVector3(Module const& module, char const* name)
+{
+    typedef BasicVector3<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_constructor(Constructor<T,double,double,double>(),
+                (Arg("x") = static_cast<double>(0),
+                Arg("y") = static_cast<double>(0),
+                Arg("z") = static_cast<double>(0)))
+        .define_method("__equal__",  &T::operator ==)
+        .define_method("memsize", &fixedMemsize<T>)
+        .define_method("to_binary", &T::toBinary)
+        .define_method("from_binary", &T::fromBinary)
+        .define_method("norm",  &T::norm)
+        .define_method("normalize!",  &T::normalizeBang)
+        .define_method("normalize",  &T::normalize)
+        .define_method("[]",  &T::get)
+        .define_method("[]=",  &T::set)
+        .define_method("x",  &T::x)
+        .define_method("y",  &T::y)
+        .define_method("z",  &T::z)
+        .define_method("x=", &T::setX)
+        .define_method("y=", &T::setY)
+        .define_method("z=", &T::setZ)
+        .define_method("+",  &T::operator +)
+        .define_method("-",  &T::operator -)
+        .define_method("/",  &T::operator /)
+        .define_method("-@", &T::negate)
+        .define_method("*",  &T::scale)
+        .define_method("add!", &T::addBang)
+        .define_method("sub!", &T::subBang)
+        .define_method("scale!", &T::scaleBang)
+        .define_method("cross", &T::cross)
+        .define_method("dot",  &T::dot)
+        .define_method("approx?", &T::isApprox, (Arg("v"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())));
+}
+
+template<typename Scalar>
+static Data_Type< BasicQuaternion<Scalar> > defineQuaternion(Module const& module, char const* name)
+{
+    typedef BasicQuaternion<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_constructor(Constructor<T,double,double,double,double>())
+        .define_method("__equal__", &T::operator ==)
+        .define_method("memsize", &fixedMemsize<T>)
+        .define_method("to_binary", &T::toBinary)
+        .define_method("from_binary", &T::fromBinary)
+        .define_method("w",  &T::w)
+        .define_method("x",  &T::x)
+        .define_method("y",  &T::y)
+        .define_method("z",  &T::z)
+        .define_method("w=", &T::setW)
+        .define_method("x=", &T::setX)
+        .define_method("y=", &T::setY)
+        .define_method("z=", &T::setZ)
+        .define_method("norm", &T::norm)
+        .define_method("concatenate", &T::concatenate)
+        .define_method("inverse", &T::inverse)
+        .define_method("transform", &T::transform)
+        .define_method("matrix", &T::matrix)
+        .define_method("normalize!", &T::normalizeBang)
+        .define_method("normalize", &T::normalize)
+        .define_method("approx?", &T::isApprox, (Arg("q"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())))
+        .define_method("to_euler", &T::toEuler)
+        .define_method("from_euler", &T::fromEuler)
+        .define_method("from_angle_axis", &T::fromAngleAxis)
+        .define_method("from_matrix", &T::fromMatrix);
+}
+
+template<typename Scalar>
+static Data_Type< BasicVectorX<Scalar> > defineVectorX(Module const& module, char const* name)
+{
+    typedef BasicVectorX<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_constructor(Constructor<T,int>(),
+                (Arg("rows") = static_cast<int>(0)))
+        .define_method("resize", &T::resize)
+        .define_method("memsize", &T::memsize)
+        .define_method("__report_memsize__", &T::reportMemsize)
+        .define_method("__equal__",  &T::operator ==)
+        .define_method("to_binary", &T::toBinary)
+        .define_method("from_binary", &T::fromBinary)
+        .define_method("norm",  &T::norm)
+        .define_method("normalize!",  &T::normalizeBang)
+        .define_method("normalize",  &T::normalize)
+        .define_method("size", &T::size)
+        .define_method("[]",  &T::get)
+        .define_method("[]=",  &T::set)
+        .define_method("from_a", &T::fromArray)
+        .define_method("to_a", &T::toArray)
+        .define_method("+",  &T::operator +)
+        .define_method("-",  &T::operator -)
+        .define_method("/",  &T::operator /)
+        .define_method("-@", &T::negate)
+        .define_method("*",  &T::scale)
+        .define_method("add!", &T::addBang)
+        .define_method("sub!", &T::subBang)
+        .define_method("scale!", &T::scaleBang)
+        .define_method("mul_into!", &T::mulInto,
+                (Arg("m"), Arg("v"), Arg("alpha") = 1.0, Arg("beta") = 0.0))
+        .define_method("segment", &vectorSegment<Scalar>)
+        .define_method("head", &vectorHead<Scalar>)
+        .define_method("tail", &vectorTail<Scalar>)
+        .define_method("__assign_linear__", &T::assignLinearCombination)
+        .define_method("dot",  &T::dot)
+        .define_method("sum", &T::sum)
+        .define_method("mean", &T::mean)
+        .define_method("min", &T::minCoeff)
+        .define_method("max", &T::maxCoeff)
+        .define_method("argmin", &T::argmin)
+        .define_method("argmax", &T::argmax)
+        .define_method("squared_norm", &T::squaredNorm)
+        .define_method("lp_norm", &T::lpNorm)
+        .define_method("cwise_abs", &T::cwiseAbs)
+        .define_method("cwise_sqrt", &T::cwiseSqrt)
+        .define_method("cwise_exp", &T::cwiseExp)
+        .define_method("cwise_log", &T::cwiseLog)
+        .define_method("cwise_square", &T::cwiseSquare)
+        .define_method("cwise_inverse", &T::cwiseInverse)
+        .define_method("cwise_abs!", &T::cwiseAbsBang)
+        .define_method("cwise_sqrt!", &T::cwiseSqrtBang)
+        .define_method("cwise_exp!", &T::cwiseExpBang)
+        .define_method("cwise_log!", &T::cwiseLogBang)
+        .define_method("cwise_square!", &T::cwiseSquareBang)
+        .define_method("cwise_inverse!", &T::cwiseInverseBang)
+        .define_method("cwise_product", &T::cwiseProduct)
+        .define_method("cwise_quotient", &T::cwiseQuotient)
+        .define_method("cwise_min", &T::cwiseMin)
+        .define_method("cwise_max", &T::cwiseMax)
+        .define_method("cwise_product!", &T::cwiseProductBang)
+        .define_method("cwise_quotient!", &T::cwiseQuotientBang)
+        .define_method("cwise_min!", &T::cwiseMinBang)
+        .define_method("cwise_max!", &T::cwiseMaxBang)
+        .define_method("cwise_clamp", &T::cwiseClamp)
+        .define_method("cwise_clamp!", &T::cwiseClampBang)
+        .define_method("cwise_select", &T::cwiseSelect)
+        .define_method("set_zero", &T::setZero)
+        .define_method("set_constant", &T::setConstant)
+        .define_method("set_random", &T::setRandom)
+        .define_method("approx?", &T::isApprox, (Arg("v"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())));
+}
+
+template<typename Scalar>
+static Data_Type< BasicMatrixX<Scalar> > defineMatrixX(Module const& module, char const* name)
+{
+    typedef BasicMatrixX<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_constructor(Constructor<T,int,int>(),
+                (Arg("rows") = static_cast<int>(0),
+                 Arg("cols") = static_cast<int>(0)))
+        .define_method("resize", &T::resize)
+        .define_method("memsize", &T::memsize)
+        .define_method("__report_memsize__", &T::reportMemsize)
+        .define_method("__equal__",  &T::operator ==)
+        .define_method("to_binary", &T::toBinary)
+        .define_method("from_binary", &T::fromBinary)
+        .define_method("T", &T::transpose)
+        .define_method("norm",  &T::norm)
+        .define_method("rows", &T::rows)
+        .define_method("cols", &T::cols)
+        .define_method("size", &T::size)
+        .define_method("[]",  &T::get)
+        .define_method("[]=",  &T::set)
+        .define_method("from_a", &T::fromArray,
+                (Arg("array"), Arg("rows") = -1, Arg("cols") = -1, Arg("column_major") = true))
+        .define_method("to_a", &T::toArray, (Arg("column_major") = true))
+        .define_method("row", &T::getRow)
+        .define_method("setRow", &T::setRow)
+        .define_method("col", &T::getColumn)
+        .define_method("setCol", &T::setColumn)
+        .define_method("+",  &T::operator +)
+        .define_method("-",  &T::operator -)
+        .define_method("/",  &T::operator /)
+        .define_method("-@", &T::negate)
+        .define_method("*",  &T::scale)
+        .define_method("add!", &T::addBang)
+        .define_method("sub!", &T::subBang)
+        .define_method("scale!", &T::scaleBang)
+        .define_method("mul_into!", &T::mulInto,
+                (Arg("a"), Arg("b"), Arg("alpha") = 1.0, Arg("beta") = 0.0))
+        .define_method("block", &matrixBlock<Scalar>)
+        .define_method("row_view", &matrixRowView<Scalar>)
+        .define_method("col_view", &matrixColView<Scalar>)
+        .define_method("__assign_linear__", &T::assignLinearCombination)
+        .define_method("dotV",  &T::dotV)
+        .define_method("dotM",  &T::dotM)
+        .define_method("sum", &T::sum)
+        .define_method("mean", &T::mean)
+        .define_method("min", &T::minCoeff)
+        .define_method("max", &T::maxCoeff)
+        .define_method("argmin", &T::argmin)
+        .define_method("argmax", &T::argmax)
+        .define_method("squared_norm", &T::squaredNorm)
+        .define_method("lp_norm", &T::lpNorm)
+        .define_method("trace", &T::trace)
+        .define_method("colwise_sum", &T::colwiseSum)
+        .define_method("colwise_mean", &T::colwiseMean)
+        .define_method("colwise_min", &T::colwiseMin)
+        .define_method("colwise_max", &T::colwiseMax)
+        .define_method("colwise_norm", &T::colwiseNorm)
+        .define_method("rowwise_sum", &T::rowwiseSum)
+        .define_method("rowwise_mean", &T::rowwiseMean)
+        .define_method("rowwise_min", &T::rowwiseMin)
+        .define_method("rowwise_max", &T::rowwiseMax)
+        .define_method("rowwise_norm", &T::rowwiseNorm)
+        .define_method("__covariance__", &T::covariance)
+        .define_method("cwise_abs", &T::cwiseAbs)
+        .define_method("cwise_sqrt", &T::cwiseSqrt)
+        .define_method("cwise_exp", &T::cwiseExp)
+        .define_method("cwise_log", &T::cwiseLog)
+        .define_method("cwise_square", &T::cwiseSquare)
+        .define_method("cwise_inverse", &T::cwiseInverse)
+        .define_method("cwise_abs!", &T::cwiseAbsBang)
+        .define_method("cwise_sqrt!", &T::cwiseSqrtBang)
+        .define_method("cwise_exp!", &T::cwiseExpBang)
+        .define_method("cwise_log!", &T::cwiseLogBang)
+        .define_method("cwise_square!", &T::cwiseSquareBang)
+        .define_method("cwise_inverse!", &T::cwiseInverseBang)
+        .define_method("cwise_product", &T::cwiseProduct)
+        .define_method("cwise_quotient", &T::cwiseQuotient)
+        .define_method("cwise_min", &T::cwiseMin)
+        .define_method("cwise_max", &T::cwiseMax)
+        .define_method("cwise_product!", &T::cwiseProductBang)
+        .define_method("cwise_quotient!", &T::cwiseQuotientBang)
+        .define_method("cwise_min!", &T::cwiseMinBang)
+        .define_method("cwise_max!", &T::cwiseMaxBang)
+        .define_method("cwise_clamp", &T::cwiseClamp)
+        .define_method("cwise_clamp!", &T::cwiseClampBang)
+        .define_method("cwise_select", &T::cwiseSelect)
+        .define_method("set_zero", &T::setZero)
+        .define_method("set_identity", &T::setIdentity)
+        .define_method("set_constant", &T::setConstant)
+        .define_method("set_random", &T::setRandom)
+        .define_method("__stack__", &T::assignStack)
+        .define_method("approx?", &T::isApprox, (Arg("m"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())));
+}
+
+template<typename Scalar>
+static Data_Type< BasicMatrixXView<Scalar> > defineMatrixXView(Module const& module, char const* name)
+{
+    typedef BasicMatrixXView<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_method("rows", &T::rows)
+        .define_method("cols", &T::cols)
+        .define_method("size", &T::size)
+        .define_method("[]",  &T::get)
+        .define_method("[]=",  &T::set)
+        .define_method("to_a", &T::toArray, (Arg("column_major") = true))
+        .define_method("to_matrix", &T::toMatrix)
+        .define_method("replace", &T::replace)
+        .define_method("+",  &T::operator +)
+        .define_method("-",  &T::operator -)
+        .define_method("/",  &T::operator /)
+        .define_method("-@", &T::negate)
+        .define_method("*",  &T::scale)
+        .define_method("add!", &T::addBang)
+        .define_method("sub!", &T::subBang)
+        .define_method("scale!", &T::scaleBang)
+        .define_method("norm",  &T::norm)
+        .define_method("dotV",  &T::dotV)
+        .define_method("dotM",  &T::dotM)
+        .define_method("approx?", &T::isApprox, (Arg("m"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())));
+}
+
+template<typename Scalar>
+static Data_Type< BasicVectorXView<Scalar> > defineVectorXView(Module const& module, char const* name)
+{
+    typedef BasicVectorXView<Scalar> T;
+    return define_class_under<T>(module, name)
+        .define_method("size", &T::size)
+        .define_method("[]",  &T::get)
+        .define_method("[]=",  &T::set)
+        .define_method("to_a", &T::toArray)
+        .define_method("to_vector", &T::toVector)
+        .define_method("replace", &T::replace)
+        .define_method("+",  &T::operator +)
+        .define_method("-",  &T::operator -)
+        .define_method("/",  &T::operator /)
+        .define_method("-@", &T::negate)
+        .define_method("*",  &T::scale)
+        .define_method("add!", &T::addBang)
+        .define_method("sub!", &T::subBang)
+        .define_method("scale!", &T::scaleBang)
+        .define_method("norm",  &T::norm)
+        .define_method("dot",  &T::dot)
+        .define_method("approx?", &T::isApprox, (Arg("v"), Arg("tolerance") = static_cast<double>(Eigen::NumTraits<Scalar>::dummy_precision())));
+}
 
 extern "C" void Init_eigen()
 {
      Rice::Module rb_mEigen = define_module("Eigen");
 
-     Data_Type<Vector3> rb_Vector3 = define_class_under<Vector3>(rb_mEigen, "Vector3")
-       .define_constructor(Constructor<Vector3,double,double,double>(),
-               (Arg("x") = static_cast<double>(0),
-               Arg("y") = static_cast<double>(0),
-               Arg("z") = static_cast<double>(0)))
-       .define_method("__equal__",  &Vector3::operator ==)
-       .define_method("norm",  &Vector3::norm)
-       .define_method("normalize!",  &Vector3::normalizeBang)
-       .define_method("normalize",  &Vector3::normalize)
-       .define_method("[]",  &Vector3::get)
-       .define_method("[]=",  &Vector3::set)
-       .define_method("x",  &Vector3::x)
-       .define_method("y",  &Vector3::y)
-       .define_method("z",  &Vector3::z)
-       .define_method("x=", &Vector3::setX)
-       .define_method("y=", &Vector3::setY)
-       .define_method("z=", &Vector3::setZ)
-       .define_method("+",  &Vector3::operator +)
-       .define_method("-",  &Vector3::operator -)
-       .define_method("/",  &Vector3::operator /)
-       .define_method("-@", &Vector3::negate)
-       .define_method("*",  &Vector3::scale)
-       .define_method("cross", &Vector3::cross)
-       .define_method("dot",  &Vector3::dot)
-       .define_method("approx?", &Vector3::isApprox, (Arg("v"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
-
-     Data_Type<Quaternion> rb_Quaternion = define_class_under<Quaternion>(rb_mEigen, "Quaternion")
-       .define_constructor(Constructor<Quaternion,double,double,double,double>())
-       .define_method("__equal__", &Quaternion::operator ==)
-       .define_method("w",  &Quaternion::w)
-       .define_method("x",  &Quaternion::x)
-       .define_method("y",  &Quaternion::y)
-       .define_method("z",  &Quaternion::z)
-       .define_method("w=", &Quaternion::setW)
-       .define_method("x=", &Quaternion::setX)
-       .define_method("y=", &Quaternion::setY)
-       .define_method("z=", &Quaternion::setZ)
-       .define_method("norm", &Quaternion::norm)
-       .define_method("concatenate", &Quaternion::concatenate)
-       .define_method("inverse", &Quaternion::inverse)
-       .define_method("transform", &Quaternion::transform)
-       .define_method("matrix", &Quaternion::matrix)
-       .define_method("normalize!", &Quaternion::normalizeBang)
-       .define_method("normalize", &Quaternion::normalize)
-       .define_method("approx?", &Quaternion::isApprox, (Arg("q"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()))
-       .define_method("to_euler", &Quaternion::toEuler)
-       .define_method("from_euler", &Quaternion::fromEuler)
-       .define_method("from_angle_axis", &Quaternion::fromAngleAxis)
-       .define_method("from_matrix", &Quaternion::fromMatrix);
+#ifdef _OPENMP
+     max_threads = Eigen::nbThreads();
+#else
+     max_threads = std::max(1u, std::thread::hardware_concurrency());
+#endif
+     rb_mEigen
+       .define_module_function("threads", &getThreads)
+       .define_module_function("threads=", &setThreads)
+       .define_module_function("openmp?", &isOpenMP)
+       .define_module_function("__eigen_threads__", &getEigenThreads)
+       .define_module_function("aligned?", &isAligned)
+       .define_module_function("__fixed_alignment__", &getFixedAlignment)
+       .define_module_function("__reported_memsize__", &getReportedMemsize);
+
+     Data_Type<Vector3> rb_Vector3 = defineVector3<double>(rb_mEigen, "Vector3")
+       .define_method("to_single", &Vector3::convert);
+     Data_Type<Vector3f> rb_Vector3f = defineVector3<float>(rb_mEigen, "Vector3f")
+       .define_method("to_double", &Vector3f::convert);
+
+     Data_Type<Quaternion> rb_Quaternion = defineQuaternion<double>(rb_mEigen, "Quaternion")
+       .define_method("to_single", &Quaternion::convert);
+     Data_Type<Quaternionf> rb_Quaternionf = defineQuaternion<float>(rb_mEigen, "Quaternionf")
+       .define_method("to_double", &Quaternionf::convert);
 
      Data_Type<AngleAxis> rb_AngleAxis = define_class_under<AngleAxis>(rb_mEigen, "AngleAxis")
        .define_constructor(Constructor<AngleAxis,double,Vector3 const&>())
        .define_method("__equal__", &AngleAxis::operator ==)
+       .define_method("memsize", &fixedMemsize<AngleAxis>)
+       .define_method("to_binary", &AngleAxis::toBinary)
+       .define_method("from_binary", &AngleAxis::fromBinary)
        .define_method("angle",  &AngleAxis::angle)
        .define_method("axis",  &AngleAxis::axis)
        .define_method("concatenate", &AngleAxis::concatenate)
@@ -1066,28 +5628,42 @@ extern "C" void Init_eigen()
        .define_method("from_quaternion", &AngleAxis::fromQuaternion)
        .define_method("from_matrix", &AngleAxis::fromMatrix);
 
-     Data_Type<VectorX> rb_VectorX = define_class_under<VectorX>(rb_mEigen, "VectorX")
-       .define_constructor(Constructor<VectorX,int>(),
-               (Arg("rows") = static_cast<int>(0)))
-       .define_method("resize", &VectorX::resize)
-       .define_method("__equal__",  &VectorX::operator ==)
-       .define_method("norm",  &VectorX::norm)
-       .define_method("normalize!",  &VectorX::normalizeBang)
-       .define_method("normalize",  &VectorX::normalize)
-       .define_method("size", &VectorX::size)
-       .define_method("[]",  &VectorX::get)
-       .define_method("[]=",  &VectorX::set)
-       .define_method("+",  &VectorX::operator +)
-       .define_method("-",  &VectorX::operator -)
-       .define_method("/",  &VectorX::operator /)
-       .define_method("-@", &VectorX::negate)
-       .define_method("*",  &VectorX::scale)
-       .define_method("dot",  &VectorX::dot)
-       .define_method("approx?", &VectorX::isApprox, (Arg("v"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
+     Data_Type<VectorX> rb_VectorX = defineVectorX<double>(rb_mEigen, "VectorX")
+       .define_method("to_single", &VectorX::convert);
+     Data_Type<VectorXf> rb_VectorXf = defineVectorX<float>(rb_mEigen, "VectorXf")
+       .define_method("to_double", &VectorXf::convert);
+
+     Data_Type<Vector3Array> rb_Vector3Array = define_class_under<Vector3Array>(rb_mEigen, "Vector3Array")
+       .define_constructor(Constructor<Vector3Array,int>(),
+               (Arg("size") = static_cast<int>(0)))
+       .define_method("__equal__",  &Vector3Array::operator ==)
+       .define_method("memsize", &Vector3Array::memsize)
+       .define_method("__report_memsize__", &Vector3Array::reportMemsize)
+       .define_method("to_binary", &Vector3Array::toBinary)
+       .define_method("from_binary", &Vector3Array::fromBinary)
+       .define_method("size", &Vector3Array::size)
+       .define_method("resize", &Vector3Array::resize)
+       .define_method("[]",  &Vector3Array::get)
+       .define_method("[]=",  &Vector3Array::set)
+       .define_method("+",  &Vector3Array::operator +)
+       .define_method("-",  &Vector3Array::operator -)
+       .define_method("*",  &Vector3Array::scale)
+       .define_method("add!", &Vector3Array::addBang)
+       .define_method("sub!", &Vector3Array::subBang)
+       .define_method("scale!", &Vector3Array::scaleBang)
+       .define_method("norms", &Vector3Array::norms)
+       .define_method("mean", &Vector3Array::mean)
+       .define_method("covariance", &Vector3Array::covariance)
+       .define_method("principal_components", &Vector3Array::principalComponents, (Arg("k") = 3))
+       .define_method("dot", &Vector3Array::dot)
+       .define_method("approx?", &Vector3Array::isApprox, (Arg("v"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
 
      Data_Type<Matrix4> rb_Matrix4 = define_class_under<Matrix4>(rb_mEigen, "Matrix4")
        .define_constructor(Constructor<Matrix4>())
        .define_method("__equal__",  &Matrix4::operator ==)
+       .define_method("memsize", &fixedMemsize<Matrix4>)
+       .define_method("to_binary", &Matrix4::toBinary)
+       .define_method("from_binary", &Matrix4::fromBinary)
        .define_method("T", &Matrix4::transpose)
        .define_method("norm",  &Matrix4::norm)
        .define_method("rows", &Matrix4::rows)
@@ -1095,57 +5671,188 @@ extern "C" void Init_eigen()
        .define_method("size", &Matrix4::size)
        .define_method("[]",  &Matrix4::get)
        .define_method("[]=",  &Matrix4::set)
+       .define_method("from_a", &Matrix4::fromArray, (Arg("array"), Arg("column_major") = true))
+       .define_method("to_a", &Matrix4::toArray, (Arg("column_major") = true))
        .define_method("+",  &Matrix4::operator +)
        .define_method("-",  &Matrix4::operator -)
        .define_method("/",  &Matrix4::operator /)
        .define_method("-@", &Matrix4::negate)
        .define_method("*",  &Matrix4::scale)
+       .define_method("add!", &Matrix4::addBang)
+       .define_method("sub!", &Matrix4::subBang)
+       .define_method("scale!", &Matrix4::scaleBang)
+       .define_method("mul_into!", &Matrix4::mulInto)
        .define_method("dotM",  &Matrix4::dotM)
        .define_method("approx?", &Matrix4::isApprox, (Arg("m"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
 
      rb_mEigen.const_set("ComputeFullU", INT2FIX(Eigen::ComputeFullU));
      rb_mEigen.const_set("ComputeThinU", INT2FIX(Eigen::ComputeThinU));
      rb_mEigen.const_set("ComputeThinV", INT2FIX(Eigen::ComputeThinV));
+     rb_mEigen.const_set("ComputeFullV", INT2FIX(Eigen::ComputeFullV));
 
      Data_Type<JacobiSVD> rb_JacobiSVD = define_class_under<JacobiSVD>(rb_mEigen, "JacobiSVD")
-        .define_method("solve", &JacobiSVD::solve);
-
-     Data_Type<MatrixX> rb_MatrixX = define_class_under<MatrixX>(rb_mEigen, "MatrixX")
-       .define_constructor(Constructor<MatrixX,int,int>(),
-               (Arg("rows") = static_cast<int>(0),
-                Arg("cols") = static_cast<int>(0)))
-       .define_method("resize", &MatrixX::resize)
-       .define_method("__equal__",  &MatrixX::operator ==)
-       .define_method("T", &MatrixX::transpose)
-       .define_method("norm",  &MatrixX::norm)
-       .define_method("rows", &MatrixX::rows)
-       .define_method("cols", &MatrixX::cols)
-       .define_method("size", &MatrixX::size)
-       .define_method("[]",  &MatrixX::get)
-       .define_method("[]=",  &MatrixX::set)
-       .define_method("row", &MatrixX::getRow)
-       .define_method("setRow", &MatrixX::setRow)
-       .define_method("col", &MatrixX::getColumn)
-       .define_method("setCol", &MatrixX::setColumn)
-       .define_method("+",  &MatrixX::operator +)
-       .define_method("-",  &MatrixX::operator -)
-       .define_method("/",  &MatrixX::operator /)
-       .define_method("-@", &MatrixX::negate)
-       .define_method("*",  &MatrixX::scale)
-       .define_method("dotV",  &MatrixX::dotV)
-       .define_method("dotM",  &MatrixX::dotM)
+        .define_method("solve", &JacobiSVD::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+        .define_method("singular_values", &JacobiSVD::singularValues)
+        .define_method("matrix_u", &JacobiSVD::matrixU)
+        .define_method("matrix_v", &JacobiSVD::matrixV)
+        .define_method("rank", &JacobiSVD::rank)
+        .define_method("threshold", &JacobiSVD::threshold)
+        .define_method("threshold=", &JacobiSVD::setThreshold);
+
+     Data_Type<BDCSVD> rb_BDCSVD = define_class_under<BDCSVD>(rb_mEigen, "BDCSVD")
+        .define_method("solve", &BDCSVD::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+        .define_method("singular_values", &BDCSVD::singularValues)
+        .define_method("matrix_u", &BDCSVD::matrixU)
+        .define_method("matrix_v", &BDCSVD::matrixV)
+        .define_method("rank", &BDCSVD::rank)
+        .define_method("threshold", &BDCSVD::threshold)
+        .define_method("threshold=", &BDCSVD::setThreshold);
+
+     Data_Type<MatrixX> rb_MatrixX = defineMatrixX<double>(rb_mEigen, "MatrixX")
+       .define_method("to_single", &MatrixX::convert)
        .define_method("jacobiSvd", &MatrixX::jacobiSvd, (Arg("flags") = 0))
-       .define_method("approx?", &MatrixX::isApprox, (Arg("m"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
+       .define_method("bdcSvd", &MatrixX::bdcSvd, (Arg("flags") = 0))
+       .define_method("llt", &MatrixX::llt)
+       .define_method("ldlt", &MatrixX::ldlt)
+       .define_method("lu", &MatrixX::lu)
+       .define_method("qr", &MatrixX::qr)
+       .define_method("__principal_components__", &MatrixX::principalComponents);
+     Data_Type<MatrixXf> rb_MatrixXf = defineMatrixX<float>(rb_mEigen, "MatrixXf")
+       .define_method("to_double", &MatrixXf::convert);
+
+     Data_Type<MatrixXView> rb_MatrixXView = defineMatrixXView<double>(rb_mEigen, "MatrixXView");
+     Data_Type<MatrixXfView> rb_MatrixXfView = defineMatrixXView<float>(rb_mEigen, "MatrixXfView");
+     Data_Type<VectorXView> rb_VectorXView = defineVectorXView<double>(rb_mEigen, "VectorXView");
+     Data_Type<VectorXfView> rb_VectorXfView = defineVectorXView<float>(rb_mEigen, "VectorXfView");
+
+     Data_Type<LLT> rb_LLT = define_class_under<LLT>(rb_mEigen, "LLT")
+       .define_constructor(Constructor<LLT>())
+       .define_method("compute", &LLT::compute)
+       .define_method("solve", &LLT::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("success?", &LLT::success)
+       .define_method("determinant", &LLT::determinant)
+       .define_method("rcond", &LLT::rcond);
+
+     Data_Type<LDLT> rb_LDLT = define_class_under<LDLT>(rb_mEigen, "LDLT")
+       .define_constructor(Constructor<LDLT>())
+       .define_method("compute", &LDLT::compute)
+       .define_method("solve", &LDLT::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("success?", &LDLT::success)
+       .define_method("determinant", &LDLT::determinant)
+       .define_method("rcond", &LDLT::rcond);
+
+     Data_Type<PartialPivLU> rb_PartialPivLU = define_class_under<PartialPivLU>(rb_mEigen, "PartialPivLU")
+       .define_constructor(Constructor<PartialPivLU>())
+       .define_method("compute", &PartialPivLU::compute)
+       .define_method("solve", &PartialPivLU::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("determinant", &PartialPivLU::determinant)
+       .define_method("rcond", &PartialPivLU::rcond);
+
+     Data_Type<ColPivHouseholderQR> rb_ColPivHouseholderQR = define_class_under<ColPivHouseholderQR>(rb_mEigen, "ColPivHouseholderQR")
+       .define_constructor(Constructor<ColPivHouseholderQR>())
+       .define_method("compute", &ColPivHouseholderQR::compute)
+       .define_method("solve", &ColPivHouseholderQR::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("rank", &ColPivHouseholderQR::rank)
+       .define_method("abs_determinant", &ColPivHouseholderQR::absDeterminant);
+
+     Data_Type<SparseMatrix> rb_SparseMatrix = define_class_under<SparseMatrix>(rb_mEigen, "SparseMatrix")
+       .define_constructor(Constructor<SparseMatrix,int,int>(),
+               (Arg("rows") = static_cast<int>(0), Arg("cols") = static_cast<int>(0)))
+       .define_method("rows", &SparseMatrix::rows)
+       .define_method("cols", &SparseMatrix::cols)
+       .define_method("nonzeros", &SparseMatrix::nonZeros)
+       .define_method("resize", &SparseMatrix::resize)
+       .define_method("memsize", &SparseMatrix::memsize)
+       .define_method("__report_memsize__", &SparseMatrix::reportMemsize)
+       .define_method("set_from_triplets", &SparseMatrix::setFromTriplets)
+       .define_method("to_triplets", &SparseMatrix::toTriplets)
+       .define_method("[]", &SparseMatrix::get)
+       .define_method("from_dense", &SparseMatrix::fromDense,
+               (Arg("matrix"), Arg("reference") = 1.0, Arg("epsilon") = 0.0))
+       .define_method("to_dense", &SparseMatrix::toDense)
+       .define_method("T", &SparseMatrix::transpose)
+       .define_method("+", &SparseMatrix::operator +)
+       .define_method("-", &SparseMatrix::operator -)
+       .define_method("*", &SparseMatrix::scale)
+       .define_method("dotV", &SparseMatrix::dotV)
+       .define_method("dotM", &SparseMatrix::dotM)
+       .define_method("norm", &SparseMatrix::norm)
+       .define_method("approx?", &SparseMatrix::isApprox, (Arg("m"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()));
+
+     Data_Type<SimplicialLDLT> rb_SimplicialLDLT = define_class_under<SimplicialLDLT>(rb_mEigen, "SimplicialLDLT")
+       .define_constructor(Constructor<SimplicialLDLT>())
+       .define_method("analyze_pattern", &SimplicialLDLT::analyzePattern)
+       .define_method("factorize", &SimplicialLDLT::factorize)
+       .define_method("compute", &SimplicialLDLT::compute)
+       .define_method("solve", &SimplicialLDLT::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("success?", &SimplicialLDLT::success)
+       .define_method("determinant", &SimplicialLDLT::determinant);
+
+     Data_Type<SparseLU> rb_SparseLU = define_class_under<SparseLU>(rb_mEigen, "SparseLU")
+       .define_constructor(Constructor<SparseLU>())
+       .define_method("analyze_pattern", &SparseLU::analyzePattern)
+       .define_method("factorize", &SparseLU::factorize)
+       .define_method("compute", &SparseLU::compute)
+       .define_method("solve", &SparseLU::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("success?", &SparseLU::success)
+       .define_method("determinant", &SparseLU::determinant);
+
+     Data_Type<ConjugateGradient> rb_ConjugateGradient = define_class_under<ConjugateGradient>(rb_mEigen, "ConjugateGradient")
+       .define_constructor(Constructor<ConjugateGradient>())
+       .define_method("analyze_pattern", &ConjugateGradient::analyzePattern)
+       .define_method("factorize", &ConjugateGradient::factorize)
+       .define_method("compute", &ConjugateGradient::compute)
+       .define_method("solve", &ConjugateGradient::solve, (Arg("rhs"), Arg("out") = Object(Qnil)))
+       .define_method("success?", &ConjugateGradient::success)
+       .define_method("tolerance", &ConjugateGradient::tolerance)
+       .define_method("tolerance=", &ConjugateGradient::setTolerance)
+       .define_method("max_iterations", &ConjugateGradient::maxIterations)
+       .define_method("max_iterations=", &ConjugateGradient::setMaxIterations)
+       .define_method("iterations", &ConjugateGradient::iterations)
+       .define_method("error", &ConjugateGradient::error);
+
+     Data_Type<MappedMatrixX> rb_MappedMatrixX = define_class_under<MappedMatrixX>(rb_mEigen, "MappedMatrixX")
+       .define_constructor(Constructor<MappedMatrixX>())
+       .define_method("__map__", &MappedMatrixX::mapFile)
+       .define_method("mapped?", &MappedMatrixX::isMapped)
+       .define_method("writable?", &MappedMatrixX::isWritable)
+       .define_method("close", &MappedMatrixX::close)
+       .define_method("memsize", &fixedMemsize<MappedMatrixX>)
+       .define_method("sync", &MappedMatrixX::sync)
+       .define_method("rows", &MappedMatrixX::rows)
+       .define_method("cols", &MappedMatrixX::cols)
+       .define_method("size", &MappedMatrixX::size)
+       .define_method("[]", &MappedMatrixX::get)
+       .define_method("[]=", &MappedMatrixX::set)
+       .define_method("to_a", &MappedMatrixX::toArray, (Arg("column_major") = true))
+       .define_method("to_matrix", &MappedMatrixX::toMatrix)
+       .define_method("replace", &MappedMatrixX::replace)
+       .define_method("T", &MappedMatrixX::transpose)
+       .define_method("norm", &MappedMatrixX::norm)
+       .define_method("dotV", &MappedMatrixX::dotV)
+       .define_method("dotM", &MappedMatrixX::dotM)
+       .define_method("approx?", &MappedMatrixX::isApprox, (Arg("m"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()))
+       .define_method("jacobiSvd", &MappedMatrixX::jacobiSvd, (Arg("flags") = 0))
+       .define_method("bdcSvd", &MappedMatrixX::bdcSvd, (Arg("flags") = 0))
+       .define_method("llt", &MappedMatrixX::llt)
+       .define_method("ldlt", &MappedMatrixX::ldlt)
+       .define_method("lu", &MappedMatrixX::lu)
+       .define_method("qr", &MappedMatrixX::qr);
 
      Data_Type<Isometry3> rb_Isometry3 = define_class_under<Isometry3>(rb_mEigen, "Isometry3")
        .define_constructor(Constructor<Isometry3>())
        .define_method("__equal__",  &Isometry3::operator ==)
+       .define_method("memsize", &fixedMemsize<Isometry3>)
+       .define_method("to_binary", &Isometry3::toBinary)
+       .define_method("from_binary", &Isometry3::fromBinary)
        .define_method("approx?", &Isometry3::isApprox, (Arg("i"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()))
        .define_method("inverse", &Isometry3::inverse)
        .define_method("translation", &Isometry3::translation)
        .define_method("rotation", &Isometry3::rotation)
        .define_method("concatenate", &Isometry3::concatenate)
        .define_method("transform", &Isometry3::transform)
+       .define_method("transform_all", &Isometry3::transformAll)
+       .define_method("transform_all!", &Isometry3::transformAllBang)
        .define_method("matrix", &Isometry3::matrix)
        .define_method("translate", &Isometry3::translate)
        .define_method("pretranslate", &Isometry3::pretranslate)
@@ -1155,16 +5862,36 @@ extern "C" void Init_eigen()
      Data_Type<Affine3> rb_Affine3 = define_class_under<Affine3>(rb_mEigen, "Affine3")
        .define_constructor(Constructor<Affine3>())
        .define_method("__equal__",  &Affine3::operator ==)
+       .define_method("memsize", &fixedMemsize<Affine3>)
+       .define_method("to_binary", &Affine3::toBinary)
+       .define_method("from_binary", &Affine3::fromBinary)
        .define_method("approx?", &Affine3::isApprox, (Arg("i"), Arg("tolerance") = Eigen::NumTraits<double>::dummy_precision()))
        .define_method("inverse", &Affine3::inverse)
        .define_method("translation", &Affine3::translation)
        .define_method("rotation", &Affine3::rotation)
        .define_method("concatenate", &Affine3::concatenate)
        .define_method("transform", &Affine3::transform)
+       .define_method("transform_all", &Affine3::transformAll)
+       .define_method("transform_all!", &Affine3::transformAllBang)
        .define_method("matrix", &Affine3::matrix)
        .define_method("translate", &Affine3::translate)
        .define_method("pretranslate", &Affine3::pretranslate)
        .define_method("rotate", &Affine3::rotate)
        .define_method("prerotate", &Affine3::prerotate);
+
+#ifdef HAVE_RUBY_MEMORY_VIEW_H
+     rb_VectorX.define_method("from_memory_view", &VectorX::fromMemoryView);
+     rb_VectorXf.define_method("from_memory_view", &VectorXf::fromMemoryView);
+     rb_MatrixX.define_method("from_memory_view", &MatrixX::fromMemoryView);
+     rb_MatrixXf.define_method("from_memory_view", &MatrixXf::fromMemoryView);
+     rb_Vector3Array.define_method("from_memory_view", &Vector3Array::fromMemoryView);
+
+     registerMemoryView(rb_VectorX);
+     registerMemoryView(rb_VectorXf);
+     registerMemoryView(rb_MatrixX);
+     registerMemoryView(rb_MatrixXf);
+     registerMemoryView(rb_Vector3Array);
+     registerMemoryView(rb_MappedMatrixX);
+#endif
 }
 
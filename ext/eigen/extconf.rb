@@ -10,4 +10,29 @@ unless pkg_config("eigen3")
                                                                     nil)}"
 end
 
+# Eigen parallelizes its matrix products with OpenMP. Enable with
+#   gem install rock-eigen -- --enable-openmp
+# or
+#   rake compile -- --enable-openmp
+if enable_config("openmp", false)
+    openmp_flags = ENV.fetch("OPENMP_FLAGS", "-fopenmp")
+    $CFLAGS += " #{openmp_flags}"
+    $CXXFLAGS += " #{openmp_flags}"
+    $LDFLAGS += " #{openmp_flags}"
+    raise "OpenMP was requested but omp.h cannot be found" unless have_header("omp.h")
+end
+
+# Aligned storage for the fixed-size types (Matrix4, Quaternion), which lets
+# Eigen use aligned SIMD loads. Enable with
+#   rake compile -- --enable-aligned
+# SIMD_FLAGS selects the instruction set, e.g. SIMD_FLAGS=-mavx2 or
+# SIMD_FLAGS=-march=native. It defaults to the compiler's baseline, so that
+# the extension runs on any machine of the target architecture
+if enable_config("aligned", false)
+    $CXXFLAGS += " -DEIGEN_RUBY_ALIGNED #{ENV.fetch('SIMD_FLAGS', '')}"
+end
+
+# Ruby 3.0 and later can share the coefficients through the MemoryView API
+have_header("ruby/memory_view.h")
+
 create_makefile("eigen/eigen")
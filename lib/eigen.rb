@@ -9,9 +9,14 @@ require "eigen/eigen"
 require "eigen/affine3"
 require "eigen/angle_axis"
 require "eigen/isometry3"
+require "eigen/lazy_expression"
+require "eigen/mapped_matrixx"
 require "eigen/matrix4"
 require "eigen/matrixx"
 require "eigen/quaternion"
+require "eigen/sparse_matrix"
+require "eigen/stats"
 require "eigen/vector3"
+require "eigen/vector3_array"
 require "eigen/vectorx"
 require "eigen/version"
@@ -14,6 +14,13 @@ module Eigen
             i
         end
 
+        # Creates a transformation from a string created by {#to_binary}
+        def self.from_binary(buffer)
+            t = new
+            t.from_binary(buffer)
+            t
+        end
+
         def dup
             raise NotImplementedError
         end
@@ -45,6 +45,13 @@ module Eigen
             aa
         end
 
+        # Creates an angle axis from a string created by {#to_binary}
+        def self.from_binary(buffer)
+            aa = new(0, Eigen::Vector3.new(1, 0, 0))
+            aa.from_binary(buffer)
+            aa
+        end
+
         # Returns a scaled axis representation that is equivalent to this
         # quaternion
         #
@@ -64,13 +71,15 @@ module Eigen
         end
 
         def _dump(_level) # :nodoc:
-            Marshal.dump(to_a)
+            to_binary
         end
 
         def self._load(coordinates) # :nodoc:
-            aa = new(0, Eigen::Vector3.new(1, 0, 0))
-            aa.from_a(Marshal.load(coordinates))
-            aa
+            return from_binary(coordinates) if coordinates.start_with?("EIG")
+
+            # Legacy Marshal format, from before the binary format
+            angle, axis = Marshal.load(coordinates)
+            new(angle, Eigen::Vector3.new(*axis))
         end
 
         def to_s # :nodoc:
@@ -0,0 +1,90 @@
+# frozen_string_literal: true
+
+module Eigen
+    # A linear combination of {MatrixX} or {VectorX} operands that is evaluated
+    # in a single native pass
+    #
+    # Expressions are created with {MatrixXBase#lazy} or {VectorXBase#lazy}
+    # and combined with +, -, unary minus and multiplication or division by a
+    # scalar. Nothing is computed until {#eval} or {#assign_to} is called,
+    # which walks the operands once without creating any temporary.
+    #
+    # @example compute a * 2 + b - c without temporaries
+    #   result = (a.lazy * 2 + b - c).eval
+    class LazyExpression
+        # The terms of the combination, as [coefficient, operand] pairs
+        #
+        # @return [Array<(Float,Object)>]
+        attr_reader :terms
+
+        def initialize(terms)
+            @terms = terms
+        end
+
+        def +(other)
+            combine(other, 1)
+        end
+
+        def -(other)
+            combine(other, -1)
+        end
+
+        def -@
+            self * -1
+        end
+
+        def *(other)
+            unless other.kind_of?(Numeric)
+                raise ArgumentError,
+                      "lazy expressions can only be multiplied by a scalar"
+            end
+
+            LazyExpression.new(terms.map { |coef, op| [coef * other, op] })
+        end
+
+        def /(other)
+            self * (1.0 / other)
+        end
+
+        # Allows to write 2 * expression
+        def coerce(other)
+            [self, other]
+        end
+
+        # Evaluates the expression in a new object of the operands' class
+        def eval
+            assign_to(terms.first[1].class.new)
+        end
+
+        # Evaluates the expression into an existing object
+        #
+        # The object is resized if needed. It may be one of the operands.
+        #
+        # @return [MatrixX,VectorX] out
+        def assign_to(out)
+            out.__assign_linear__(terms.map(&:first), terms.map(&:last))
+            out
+        end
+
+        private
+
+        def combine(other, sign)
+            other_terms =
+                if other.kind_of?(LazyExpression)
+                    other.terms
+                else
+                    [[1.0, other]]
+                end
+
+            result = terms.dup
+            other_terms.each do |coef, op|
+                if (index = result.index { |_, existing| existing.equal?(op) })
+                    result[index] = [result[index][0] + sign * coef, op]
+                else
+                    result << [sign * coef, op]
+                end
+            end
+            LazyExpression.new(result)
+        end
+    end
+end
@@ -0,0 +1,42 @@
+# frozen_string_literal: true
+
+module Eigen
+    # Matrix of doubles stored in a memory-mapped file
+    #
+    # @see MatrixX.mmap
+    class MappedMatrixX
+        # The File modes used to open the file for each mapping mode
+        FILE_MODES = { "r" => "rb", "r+" => "r+b", "w+" => "w+b" }.freeze
+
+        # Maps a file of rows * cols doubles
+        #
+        # @param (see MatrixX.mmap)
+        # @return [MappedMatrixX]
+        def self.open(path, rows, cols, mode = "r")
+            file_mode = FILE_MODES.fetch(mode) do
+                raise ArgumentError,
+                      "invalid mode #{mode.inspect}, expected one of "\
+                      "#{FILE_MODES.keys.map(&:inspect).join(', ')}"
+            end
+
+            size = rows * cols * 8
+            File.open(path, file_mode) do |io|
+                if mode == "w+"
+                    io.truncate(size)
+                elsif io.size < size
+                    raise ArgumentError,
+                          "#{path} is #{io.size} bytes long, expected at least "\
+                          "#{size} bytes for a #{rows}x#{cols} matrix"
+                end
+
+                m = new
+                m.__map__(io.fileno, rows, cols, mode != "r")
+                m
+            end
+        end
+
+        def to_s # :nodoc:
+            "MappedMatrixX(#{rows}x#{cols})"
+        end
+    end
+end
@@ -19,48 +19,11 @@ module Eigen
             m
         end
 
-        # Returns the values flattened in a ruby array
-        #
-        # @param [Boolean] column_major if true, the values of a column will be
-        #   adjacent in the resulting array, if not the values of a row will
-        # @return [Array<Numeric>]
-        #
-        # @example column-major ordering
-        #   matrix.to_s => Matrix4(1 2 3 4
-        #                          5 6 7 8
-        #                          9 10 11 12
-        #                          13 14 15 16)
-        #   matrix.to_a(true) => [1 5 9 13 2 6 10 14 ...]
-        def to_a(column_major = true)
-            a = []
-            if column_major
-                (0..3).each do |j|
-                    (0..3).each do |i|
-                        a << self[i, j]
-                    end
-                end
-            else
-                (0..3).each do |i|
-                    (0..3).each do |j|
-                        a << self[i, j]
-                    end
-                end
-            end
-            a
-        end
-
-        # sets matrix from a 1d array
-        def from_a(array, column_major = true)
-            raise ArgumentError, "array should be of size maximum 16" if array.size > 16
-
-            16.times do |i|
-                v = array[i] || 0
-                if column_major
-                    self[i % 4, i / 4] = v
-                else
-                    self[i / 4, i % 4] = v
-                end
-            end
+        # Creates a matrix from a string created by {#to_binary}
+        def self.from_binary(buffer)
+            m = new
+            m.from_binary(buffer)
+            m
         end
 
         def ==(other)
@@ -79,14 +42,18 @@ module Eigen
         end
 
         def _dump(_level)
-            to_a.pack("E*")
+            to_binary
         end
 
         def self._load(elements) # :nodoc:
             m = new
             if elements.size == 8 * 16
+                # Legacy packed format, from before the binary format
                 m.from_a(elements.unpack("E*"))
+            elsif elements.start_with?("EIG")
+                m.from_binary(elements)
             else
+                # Legacy Marshal format, from before the packed format
                 m.from_a(Marshal.load(elements)["data"])
             end
             m
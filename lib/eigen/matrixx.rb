@@ -1,84 +1,123 @@
 # frozen_string_literal: true
 
 module Eigen
-    # Abritary size vector
-    class MatrixX
-        def dup
-            MatrixX.from_a(to_a, rows, cols)
+    # Methods shared by {MatrixX} and its single-precision version {MatrixXf}
+    module MatrixXBase
+        def self.included(base)
+            base.extend ClassMethods
         end
 
-        def self.Zero(rows, cols)
-            m = new(rows, cols)
-            rows.times do |r|
-                cols.times do |c|
-                    m[r, c] = 0
-                end
+        # Class methods shared by {MatrixX} and {MatrixXf}
+        module ClassMethods
+            # Creates a matrix filled with zeros
+            def Zero(rows, cols)
+                m = new
+                m.set_zero(rows, cols)
+                m
             end
-            m
-        end
 
-        def self.from_a(*args)
-            m = new
-            m.from_a(*args)
-            m
-        end
+            # Creates an identity matrix
+            #
+            # Non-square matrices have ones on their main diagonal
+            def Identity(rows, cols = rows)
+                m = new
+                m.set_identity(rows, cols)
+                m
+            end
 
-        # Returns the array value in a vector
-        def to_a(column_major = true)
-            if column_major
-                to_a_column_major
-            else
-                to_a_row_major
+            # Creates a matrix whose coefficients are all value
+            def Constant(rows, cols, value)
+                m = new
+                m.set_constant(rows, cols, value)
+                m
             end
-        end
 
-        # @api private
-        #
-        # Helper for #to_a
-        def to_a_column_major
-            a = []
-            cols.times do |j|
-                rows.times do |i|
-                    a << self[i, j]
-                end
+            # Creates a matrix of random coefficients in [-1, 1]
+            #
+            # @see #set_random
+            def Random(rows, cols)
+                m = new
+                m.set_random(rows, cols)
+                m
             end
-            a
-        end
 
-        # @api private
-        #
-        # Helper for {#to_a}
-        def to_a_row_major
-            a = []
-            rows.times do |i|
-                cols.times do |j|
-                    a << self[i, j]
-                end
+            # Concatenates matrices side by side
+            #
+            # @param [Array<MatrixX,VectorX>] blocks the matrices, which must
+            #   have the same number of rows. Vectors are single columns
+            # @return [MatrixX]
+            def hstack(blocks)
+                m = new
+                m.__stack__(blocks, true)
+                m
             end
-            a
-        end
 
-        # sets matrix from a 1d array
-        def from_a(array, nrows = -1, ncols = -1, column_major = true)
-            if nrows == -1 && ncols == -1
-                nrows = rows
-                ncols = cols
-            elsif nrows == -1
-                nrows = array.size / ncols
-            elsif ncols == -1
-                ncols = array.size / nrows
+            # Concatenates matrices on top of each other
+            #
+            # @param [Array<MatrixX,VectorX>] blocks the matrices, which must
+            #   have the same number of columns. Vectors are single columns
+            # @return [MatrixX]
+            def vstack(blocks)
+                m = new
+                m.__stack__(blocks, false)
+                m
             end
 
-            resize(nrows, ncols)
-            array.each_index do |i|
-                v = array[i]
-                v ||= 0.0
-                if column_major
-                    self[i % nrows, i / nrows] = v
-                else
-                    self[i / ncols, i % ncols] = v
-                end
+            def from_a(*args)
+                m = new
+                m.from_a(*args)
+                m
+            end
+
+            # Creates a matrix from a string created by {#to_binary}
+            def from_binary(buffer)
+                m = new
+                m.from_binary(buffer)
+                m
+            end
+
+            # Creates a matrix from the coefficients of an object exporting a
+            # memory view, e.g. a Numo::NArray
+            #
+            # @see #from_memory_view
+            def from_memory_view(object)
+                m = new
+                m.from_memory_view(object)
+                m
             end
+
+            def _load(coordinates) # :nodoc:
+                return from_binary(coordinates) if coordinates.start_with?("EIG")
+
+                # Legacy Marshal format, from before the binary format
+                o = Marshal.load(coordinates)
+                m = new(o["rows"], o["cols"])
+                m.from_a(o["data"], o["rows"], o["cols"])
+                m
+            end
+        end
+
+        # Starts a lazy expression on this object
+        #
+        # @return [LazyExpression]
+        # @see LazyExpression
+        def lazy
+            LazyExpression.new([[1.0, self]])
+        end
+
+        def dup
+            self.class.from_a(to_a, rows, cols)
+        end
+
+        # Sample covariance of a set of observations
+        #
+        # @param [Boolean] rowwise if true, each row of this matrix is an
+        #   observation, otherwise each column is
+        # @return [MatrixX,MatrixXf] the covariance, whose size is the
+        #   dimension of the observations
+        # @raise [ArgumentError] if there are less than 2 observations
+        def covariance(rowwise: true)
+            __covariance__(rowwise)
         end
 
         def pretty_print(pp)
@@ -96,7 +135,7 @@ module Eigen
         end
 
         def to_s # :nodoc:
-            str = "MatrixX(\n"
+            str = "#{self.class.name.split('::').last}(\n"
             (0..rows - 1).each do |i|
                 (0..cols - 1).each do |j|
                     str += "#{self[i, j]} "
@@ -108,14 +147,78 @@ module Eigen
         end
 
         def _dump(_level) # :nodoc:
-            Marshal.dump({ "rows" => rows, "cols" => cols, "data" => to_a })
+            to_binary
+        end
+    end
+
+    # Abritary size vector
+    class MatrixX
+        include MatrixXBase
+
+        # Maps a file of raw doubles as a matrix
+        #
+        # The file holds the coefficients in column-major order, in the
+        # machine's byte order, without any header. It is not loaded: pages
+        # are read on demand by the system.
+        #
+        # @param [String] path
+        # @param [Integer] rows
+        # @param [Integer] cols
+        # @param [String] mode "r" to map read-only, "r+" to map read-write,
+        #   in which case modifications are written to the file, and "w+" to
+        #   create or truncate the file to the matrix size and map it
+        #   read-write
+        # @return [MappedMatrixX]
+        def self.mmap(path, rows, cols, mode = "r")
+            MappedMatrixX.open(path, rows, cols, mode)
         end
 
-        def self._load(coordinates) # :nodoc:
-            o = Marshal.load(coordinates)
-            m = new(o["rows"], o["cols"])
-            m.from_a(o["data"], o["rows"], o["cols"])
-            m
+        # Minimum of rows and columns above which {#svd} uses {#bdcSvd}
+        SVD_BDC_MIN_SIZE = 16
+
+        # Computes the singular value decomposition of this matrix
+        #
+        # @param [Integer] flags OR-ed values of Eigen::ComputeFullU,
+        #   Eigen::ComputeThinU, Eigen::ComputeFullV and Eigen::ComputeThinV
+        # @param [Symbol] algorithm either :jacobi, :bdc or :auto. :auto
+        #   picks :bdc when both dimensions are at least {SVD_BDC_MIN_SIZE}
+        # @return [JacobiSVD,BDCSVD]
+        def svd(flags = ComputeThinU | ComputeThinV, algorithm: :auto)
+            if algorithm == :auto
+                algorithm = [rows, cols].min >= SVD_BDC_MIN_SIZE ? :bdc : :jacobi
+            end
+
+            case algorithm
+            when :jacobi then jacobiSvd(flags)
+            when :bdc then bdcSvd(flags)
+            else
+                raise ArgumentError,
+                      "unknown SVD algorithm #{algorithm.inspect}, "\
+                      "expected :auto, :jacobi or :bdc"
+            end
         end
+
+        # Principal component analysis of a set of observations
+        #
+        # Observations of up to 16 dimensions go through the
+        # eigendecomposition of their covariance, larger ones through the SVD
+        # of the centered observations.
+        #
+        # @param [Integer] k the number of components, at most the dimension
+        #   of the observations
+        # @param [Boolean] rowwise if true, each row of this matrix is an
+        #   observation, otherwise each column is
+        # @return [(MatrixX,VectorX)] the principal axes as the columns of a
+        #   matrix, and the variance along each of them, by decreasing
+        #   variance
+        # @raise [ArgumentError] if there are less than 2 observations
+        def principal_components(k, rowwise: true)
+            __principal_components__(k, rowwise)
+        end
+    end
+
+    # Abritary size matrix in single precision
+    class MatrixXf
+        include MatrixXBase
     end
 end
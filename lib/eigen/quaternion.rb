@@ -1,34 +1,80 @@
 # frozen_string_literal: true
 
 module Eigen
-    # Representation and manipulation of a quaternion
-    class Quaternion
-        def dup
-            Quaternion.new(w, x, y, z)
+    # Methods shared by {Quaternion} and its single-precision version
+    # {Quaternionf}
+    #
+    # The including class must define VECTOR3_CLASS, the vector class of the
+    # same precision
+    module QuaternionBase
+        def self.included(base)
+            base.extend ClassMethods
         end
 
-        # Returns the quaternion as [w, x, y, z]
-        def to_a
-            [w, x, y, z]
-        end
+        # Class methods shared by {Quaternion} and {Quaternionf}
+        module ClassMethods
+            # Returns the identity unit quaternion (identity rotation)
+            def Identity
+                new(1, 0, 0, 0)
+            end
+
+            # DEPRECATED: please use identity instead. Returns the unit quaternion
+            # (identity rotation)
+            def Unit # rubocop:disable Naming/MethodName
+                warn "[DEPRECATED] Quaternion.unit, please use Quaternion.identity."
+                self.Identity
+            end
+
+            # Creates a quaternion from an angle and axis description
+            def from_angle_axis(*args)
+                q = new(1, 0, 0, 0)
+                q.from_angle_axis(*args)
+                q
+            end
+
+            # Creates a quaternion from a set of euler angles.
+            #
+            # See Quaternion#from_euler for details
+            def from_euler(*args)
+                q = new(1, 0, 0, 0)
+                q.from_euler(*args)
+                q
+            end
 
-        # Returns the identity unit quaternion (identity rotation)
-        def self.Identity
-            Quaternion.new(1, 0, 0, 0)
+            # Creates a quaternion from a rotation matrix
+            def from_matrix(m)
+                q = new(1, 0, 0, 0)
+                q.from_matrix(m)
+                q
+            end
+
+            # Creates a quaternion from a string created by {#to_binary}
+            def from_binary(buffer)
+                q = new(1, 0, 0, 0)
+                q.from_binary(buffer)
+                q
+            end
+
+            # The inverse of #yaw
+            def from_yaw(yaw)
+                from_euler(self::VECTOR3_CLASS.new(yaw, 0, 0), 2, 1, 0)
+            end
+
+            def _load(coordinates) # :nodoc:
+                return from_binary(coordinates) if coordinates.start_with?("EIG")
+
+                # Legacy Marshal format, from before the binary format
+                new(*Marshal.load(coordinates))
+            end
         end
 
-        # DEPRECATED: please use identity instead. Returns the unit quaternion
-        # (identity rotation)
-        def self.Unit # rubocop:disable Naming/MethodName
-            warn "[DEPRECATED] Quaternion.unit, please use Quaternion.identity."
-            self.Identity
+        def dup
+            self.class.new(w, x, y, z)
         end
 
-        # Creates a quaternion from an angle and axis description
-        def self.from_angle_axis(*args)
-            q = new(1, 0, 0, 0)
-            q.from_angle_axis(*args)
-            q
+        # Returns the quaternion as [w, x, y, z]
+        def to_a
+            [w, x, y, z]
         end
 
         # Returns an angle,axis representation equivalent to this quaternion
@@ -43,10 +89,10 @@ module Eigen
         def to_angle_axis(eps = 1e-12)
             w, x, y, z = to_a
             norm  = Math.sqrt(x * x + y * y + z * z)
-            return 0, Eigen::Vector3.new(0, 0, 1) if norm < eps
+            return 0, self.class::VECTOR3_CLASS.new(0, 0, 1) if norm < eps
 
             angle = 2.0 * Math.atan2(norm, w)
-            axis  = Eigen::Vector3.new(x, y, z) / norm
+            axis  = self.class::VECTOR3_CLASS.new(x, y, z) / norm
             [angle, axis]
         end
 
@@ -60,22 +106,6 @@ module Eigen
             axis * angle
         end
 
-        # Creates a quaternion from a set of euler angles.
-        #
-        # See Quaternion#from_euler for details
-        def self.from_euler(*args)
-            q = new(1, 0, 0, 0)
-            q.from_euler(*args)
-            q
-        end
-
-        # Creates a quaternion from a rotation matrix
-        def self.from_matrix(m)
-            q = new(1, 0, 0, 0)
-            q.from_matrix(m)
-            q
-        end
-
         # Extracts the yaw angle from this quaternion
         #
         # It decomposes the quaternion in euler angles using to_euler
@@ -92,14 +122,9 @@ module Eigen
             to_euler[2]
         end
 
-        # The inverse of #yaw
-        def self.from_yaw(yaw)
-            from_euler(Eigen::Vector3.new(yaw, 0, 0), 2, 1, 0)
-        end
-
         # Concatenates with another quaternion or transforms a vector
         def *(other)
-            if other.kind_of?(Quaternion)
+            if other.kind_of?(self.class)
                 concatenate(other)
             else
                 transform(other)
@@ -107,15 +132,11 @@ module Eigen
         end
 
         def _dump(_level) # :nodoc:
-            Marshal.dump(to_a)
-        end
-
-        def self._load(coordinates) # :nodoc:
-            new(*Marshal.load(coordinates))
+            to_binary
         end
 
         def to_s # :nodoc:
-            "Quaternion(#{w}, (#{x}, #{y}, #{z}))"
+            "#{self.class.name.split('::').last}(#{w}, (#{x}, #{y}, #{z}))"
         end
 
         # Tests for equality
@@ -251,4 +272,18 @@ module Eigen
             Qt::Quaternion.new(w, x, y, z)
         end
     end
+
+    # Representation and manipulation of a quaternion
+    class Quaternion
+        VECTOR3_CLASS = Vector3
+
+        include QuaternionBase
+    end
+
+    # Representation and manipulation of a quaternion in single precision
+    class Quaternionf
+        VECTOR3_CLASS = Vector3f
+
+        include QuaternionBase
+    end
 end
@@ -0,0 +1,42 @@
+# frozen_string_literal: true
+
+module Eigen
+    # Variable-size sparse matrix
+    class SparseMatrix
+        # Creates a matrix from its non-zero coefficients
+        #
+        # @param [Integer] rows
+        # @param [Integer] cols
+        # @param (see #set_from_triplets)
+        # @return [SparseMatrix]
+        def self.from_triplets(rows, cols, row_indices, col_indices, values)
+            m = new(rows, cols)
+            m.set_from_triplets(row_indices, col_indices, values)
+            m
+        end
+
+        # Creates a sparse matrix from the non-zero coefficients of a dense one
+        #
+        # @param [MatrixX] matrix
+        # @return [SparseMatrix]
+        def self.from_dense(matrix)
+            m = new
+            m.from_dense(matrix)
+            m
+        end
+
+        def dup
+            self.class.from_triplets(rows, cols, *to_triplets)
+        end
+
+        def ==(other)
+            other.kind_of?(self.class) &&
+                rows == other.rows && cols == other.cols &&
+                to_triplets == other.to_triplets
+        end
+
+        def to_s # :nodoc:
+            "SparseMatrix(#{rows}x#{cols}, #{nonzeros} non-zeros)"
+        end
+    end
+end
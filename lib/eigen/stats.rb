@@ -0,0 +1,164 @@
+# frozen_string_literal: true
+
+module Eigen
+    # Opt-in instrumentation of the bindings
+    #
+    # Once enabled, every native method of the Eigen classes counts its calls
+    # and their cumulative time, and the objects holding a heap payload
+    # (vectors, matrices, ...) report its size to Ruby's GC so that it
+    # accounts for them when deciding to start a collection.
+    #
+    # The instrumentation wraps the native methods when it is enabled, and
+    # disabling it puts the original methods back, so that it costs nothing
+    # while disabled.
+    #
+    # @see Eigen.stats
+    module Stats
+        @enabled = false
+        @originals = nil
+        @calls = {}
+
+        class << self
+            # The per-method statistics, as "Class#method" => [count, time]
+            attr_reader :calls
+        end
+
+        def self.enabled?
+            @enabled
+        end
+
+        def self.enable
+            install unless @originals
+            @enabled = true
+        end
+
+        def self.disable
+            uninstall if @originals
+            @enabled = false
+        end
+
+        # Resets the call statistics
+        def self.reset
+            @calls = {}
+        end
+
+        # @api private
+        def self.record(key, duration)
+            entry = (@calls[key] ||= [0, 0.0])
+            entry[0] += 1
+            entry[1] += duration
+        end
+
+        # The Eigen classes
+        def self.classes
+            Eigen.constants.map { |name| Eigen.const_get(name) }.grep(Class)
+        end
+
+        # Live objects and the memory they use, per class
+        #
+        # This walks the object space, it is not meant to be called often
+        #
+        # @return [Hash<String,Hash>] for each class name, the number of live
+        #   objects (:count) and the bytes they use, as reported by their
+        #   memsize method (:bytes)
+        def self.objects
+            classes.each_with_object({}) do |klass, result|
+                count = 0
+                bytes = 0
+                ObjectSpace.each_object(klass) do |obj|
+                    count += 1
+                    bytes += memsize_of(obj)
+                end
+                result[klass.name] = { count: count, bytes: bytes } if count > 0
+            end
+        end
+
+        # @api private
+        def self.memsize_of(obj)
+            obj.respond_to?(:memsize) ? obj.memsize : 0
+        rescue StandardError
+            # Allocated but not initialized
+            0
+        end
+
+        # Replaces the native methods of each Eigen class by wrappers
+        # recording their calls
+        def self.install
+            @originals = classes.to_h do |klass|
+                [klass, instrumented_methods(klass).to_h do |name|
+                    original = klass.instance_method(name)
+                    define_instrumented_method(klass, "#{klass.name}##{name}", original)
+                    [name, original]
+                end]
+            end
+        end
+
+        # Restores the native methods replaced by {install}
+        def self.uninstall
+            @originals.each do |klass, methods|
+                methods.each do |name, original|
+                    klass.send(:define_method, name, original)
+                end
+            end
+            @originals = nil
+        end
+
+        # @api private
+        #
+        # The names of the native methods of klass
+        def self.instrumented_methods(klass)
+            names = klass.public_instance_methods(false)
+            names << :initialize if klass.private_instance_methods(false).include?(:initialize)
+            names.reject do |name|
+                # Methods defined in Ruby, and internal helpers among which the
+                # GC reporting the wrappers call
+                klass.instance_method(name).source_location || name.start_with?("__")
+            end
+        end
+
+        # @api private
+        def self.define_instrumented_method(klass, key, original)
+            klass.send(:define_method, original.name) do |*args, &block|
+                start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+                begin
+                    result = original.bind_call(self, *args, &block)
+                ensure
+                    Stats.record(key, Process.clock_gettime(Process::CLOCK_MONOTONIC) - start)
+                end
+                __report_memsize__ if respond_to?(:__report_memsize__)
+                result.__report_memsize__ if result.respond_to?(:__report_memsize__)
+                result
+            end
+        end
+    end
+
+    # Whether the instrumentation is enabled
+    #
+    # @see Stats
+    def self.stats_enabled?
+        Stats.enabled?
+    end
+
+    # Enables or disables the instrumentation
+    #
+    # @see Stats
+    def self.stats_enabled=(flag)
+        flag ? Stats.enable : Stats.disable
+    end
+
+    # Statistics about the native objects and calls
+    #
+    # @return [Hash] with keys
+    #   - :objects, the live objects and bytes per class, see {Stats.objects}
+    #   - :calls, for each native method called while the instrumentation was
+    #     enabled, the number of calls (:count) and their cumulative time in
+    #     seconds (:time)
+    #   - :reported_bytes, the payload size currently reported to Ruby's GC
+    def self.stats
+        calls = Stats.calls.transform_values do |count, time|
+            { count: count, time: time }
+        end
+        { objects: Stats.objects, calls: calls,
+          reported_bytes: __reported_memsize__ }
+    end
+end
@@ -1,15 +1,57 @@
 # frozen_string_literal: true
 
 module Eigen
-    # 3-dimensional vector
-    class Vector3
-        # Returns a vector with all values set to Base.unset
-        def self.Unset
-            Vector3.new(Base.unset, Base.unset, Base.unset)
+    # Methods shared by {Vector3} and its single-precision version {Vector3f}
+    module Vector3Base
+        def self.included(base)
+            base.extend ClassMethods
+        end
+
+        # Class methods shared by {Vector3} and {Vector3f}
+        module ClassMethods
+            # Returns a vector with all values set to Base.unset
+            def Unset
+                new(Base.unset, Base.unset, Base.unset)
+            end
+
+            # Creates a vector from a string created by {#to_binary}
+            def from_binary(buffer)
+                v = new
+                v.from_binary(buffer)
+                v
+            end
+
+            # Returns the (1, 0, 0) unit vector
+            def UnitX
+                new(1, 0, 0)
+            end
+
+            # Returns the (0, 1, 0) unit vector
+            def UnitY
+                new(0, 1, 0)
+            end
+
+            # Returns the (0, 0, 1) unit vector
+            def UnitZ
+                new(0, 0, 1)
+            end
+
+            # returns the (0, 0, 0) vector
+            def Zero
+                new(0, 0, 0)
+            end
+
+            # Support for Marshal
+            def _load(coordinates) # :nodoc:
+                return from_binary(coordinates) if coordinates.start_with?("EIG")
+
+                # Legacy Marshal format, from before the binary format
+                new(*Marshal.load(coordinates))
+            end
         end
 
         def dup
-            Vector3.new(x, y, z)
+            self.class.new(x, y, z)
         end
 
         # Returns the [x, y, z] tuple
@@ -17,26 +59,6 @@ module Eigen
             [x, y, z]
         end
 
-        # Returns the (1, 0, 0) unit vector
-        def self.UnitX
-            Vector3.new(1, 0, 0)
-        end
-
-        # Returns the (0, 1, 0) unit vector
-        def self.UnitY
-            Vector3.new(0, 1, 0)
-        end
-
-        # Returns the (0, 0, 1) unit vector
-        def self.UnitZ
-            Vector3.new(0, 0, 1)
-        end
-
-        # returns the (0, 0, 0) vector
-        def self.Zero
-            Vector3.new(0, 0, 0)
-        end
-
         # Returns the angle formed by +self+ and +v+, oriented from +self+ to
         # +v+
         def angle_to(v)
@@ -61,16 +83,11 @@ module Eigen
 
         # Support for Marshal
         def _dump(_level) # :nodoc:
-            Marshal.dump(to_a)
-        end
-
-        # Support for Marshal
-        def self._load(coordinates) # :nodoc:
-            new(*Marshal.load(coordinates))
+            to_binary
         end
 
         def to_s # :nodoc:
-            "Vector3(#{x}, #{y}, #{z})"
+            "#{self.class.name.split('::').last}(#{x}, #{y}, #{z})"
         end
 
         def data
@@ -173,4 +190,14 @@ module Eigen
             Qt::Vector3D.new(x, y, z)
         end
     end
+
+    # 3-dimensional vector
+    class Vector3
+        include Vector3Base
+    end
+
+    # 3-dimensional vector in single precision
+    class Vector3f
+        include Vector3Base
+    end
 end
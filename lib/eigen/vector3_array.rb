@@ -0,0 +1,71 @@
+# frozen_string_literal: true
+
+module Eigen
+    # List of 3-vectors stored contiguously
+    #
+    # Operations such as {#+}, {#norms} or {#dot} are applied on all vectors
+    # in a single call
+    class Vector3Array
+        include Enumerable
+
+        # Creates an array from a string created by {#to_binary}
+        def self.from_binary(buffer)
+            a = new
+            a.from_binary(buffer)
+            a
+        end
+
+        # Creates an array from an object exporting a Nx3 memory view
+        #
+        # @see #from_memory_view
+        def self.from_memory_view(object)
+            a = new
+            a.from_memory_view(object)
+            a
+        end
+
+        # Creates an array from a list of vectors
+        #
+        # @param [Array<Vector3>] vectors
+        # @return [Vector3Array]
+        def self.from_vectors(vectors)
+            a = new(vectors.size)
+            vectors.each_with_index { |v, i| a[i] = v }
+            a
+        end
+
+        # Enumerates copies of the vectors
+        #
+        # @yieldparam [Vector3] v
+        def each
+            return enum_for(__method__) { size } unless block_given?
+
+            size.times { |i| yield(self[i]) }
+        end
+
+        def empty?
+            size.zero?
+        end
+
+        def dup
+            Vector3Array.from_binary(to_binary)
+        end
+
+        def ==(other)
+            other.kind_of?(self.class) &&
+                __equal__(other)
+        end
+
+        def to_s # :nodoc:
+            "Vector3Array(#{map(&:to_s).join(', ')})"
+        end
+
+        def _dump(_level) # :nodoc:
+            to_binary
+        end
+
+        def self._load(buffer) # :nodoc:
+            from_binary(buffer)
+        end
+    end
+end
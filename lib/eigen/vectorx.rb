@@ -1,32 +1,80 @@
 # frozen_string_literal: true
 
 module Eigen
-    # Abritary size vector
-    class VectorX
-        def dup
-            VectorX.from_a(to_a)
+    # Methods shared by {VectorX} and its single-precision version {VectorXf}
+    module VectorXBase
+        def self.included(base)
+            base.extend ClassMethods
         end
 
-        # Returns the array value in a vector
-        def to_a
-            a = []
-            (0..size - 1).each do |i|
-                a << self[i]
+        # Class methods shared by {VectorX} and {VectorXf}
+        module ClassMethods
+            # Creates a vector filled with zeros
+            def Zero(size)
+                v = new
+                v.set_zero(size)
+                v
+            end
+
+            # Creates a vector whose coefficients are all value
+            def Constant(size, value)
+                v = new
+                v.set_constant(size, value)
+                v
+            end
+
+            # Creates a vector of random coefficients in [-1, 1]
+            #
+            # @see #set_random
+            def Random(size)
+                v = new
+                v.set_random(size)
+                v
+            end
+
+            def from_a(array)
+                v = new
+                v.from_a(array)
+                v
+            end
+
+            # Creates a vector from a string created by {#to_binary}
+            def from_binary(buffer)
+                v = new
+                v.from_binary(buffer)
+                v
+            end
+
+            # Creates a vector from the coefficients of an object exporting a
+            # memory view, e.g. a Numo::NArray
+            #
+            # @see #from_memory_view
+            def from_memory_view(object)
+                v = new
+                v.from_memory_view(object)
+                v
+            end
+
+            def _load(coordinates) # :nodoc:
+                return from_binary(coordinates) if coordinates.start_with?("EIG")
+
+                # Legacy Marshal format, from before the binary format
+                m = new
+                m.from_a(Marshal.load(coordinates))
+                m
             end
-            a
         end
 
-        def self.from_a(array)
-            v = VectorX.new
-            v.from_a(array)
-            v
+        # Starts a lazy expression on this object
+        #
+        # @return [LazyExpression]
+        # @see LazyExpression
+        def lazy
+            LazyExpression.new([[1.0, self]])
         end
 
-        def from_a(array)
-            resize(array.size)
-            (0..array.size - 1).each do |i|
-                self[i] = array[i]
-            end
+        def dup
+            self.class.from_a(to_a)
         end
 
         def ==(other)
@@ -35,7 +83,7 @@ module Eigen
         end
 
         def to_s # :nodoc:
-            str = "VectorX("
+            str = "#{self.class.name.split('::').last}("
             (0..size - 1).each do |i|
                 str += "#{self[i]} "
             end
@@ -44,13 +92,17 @@ module Eigen
         end
 
         def _dump(_level) # :nodoc:
-            Marshal.dump(to_a)
+            to_binary
         end
+    end
 
-        def self._load(coordinates) # :nodoc:
-            m = new
-            m.from_a(Marshal.load(coordinates))
-            m
-        end
+    # Abritary size vector
+    class VectorX
+        include VectorXBase
+    end
+
+    # Abritary size vector in single precision
+    class VectorXf
+        include VectorXBase
     end
 end
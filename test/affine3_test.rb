@@ -56,6 +56,17 @@ class TCEigenAffine3 < Minitest::Test
         )
     end
 
+    def test_transform_all
+        q = Eigen::Quaternion.from_angle_axis(0.4, Eigen::Vector3.UnitZ)
+        t = Eigen::Affine3.from_position_orientation(Eigen::Vector3.new(1, 2, 3), q)
+        array = Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 0, 0), Eigen::Vector3.new(0, 1, 0)]
+        )
+        result = t.transform_all(array)
+        assert_approx_equal t * array[0], result[0]
+        assert_approx_equal t * array[1], result[1]
+    end
+
     def test_inverse
         v = Eigen::Vector3.new(1, 2, 3)
         q = Eigen::Quaternion.new(0, 0, 1, 0)
@@ -82,4 +93,25 @@ class TCEigenAffine3 < Minitest::Test
         t2 = Eigen::Affine3.from_position_orientation(v, q)
         refute_approx_equal t1, t2
     end
+
+    def test_transform_all_in_parallel
+        q = Eigen::Quaternion.from_angle_axis(0.4, Eigen::Vector3.UnitZ)
+        t = Eigen::Affine3.from_position_orientation(Eigen::Vector3.new(1, 2, 3), q)
+        # More than two slices of PARALLEL_MIN_ITEMS_PER_THREAD points
+        count = 3 * 32_768
+        points = Eigen::MatrixX.from_a((0...3 * count).map { |i| i % 97 }, 3, count)
+        array = Eigen::Vector3Array.from_binary(points.to_binary)
+
+        threads = Eigen.threads
+        Eigen.threads = 1
+        expected = t.transform_all(array)
+        Eigen.threads = 2
+        assert_equal expected, t.transform_all(array)
+        out = array.dup
+        t.transform_all!(out)
+        assert_equal expected, out
+        assert_approx_equal t * array[count - 1], expected[count - 1]
+    ensure
+        Eigen.threads = threads if threads
+    end
 end
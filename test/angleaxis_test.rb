@@ -73,6 +73,20 @@ class TCEigenAngleAxis < Minitest::Test
         assert_approx_equal aa, loaded, 0.0001
     end
 
+    def test_marshal_loads_the_legacy_format
+        aa = Eigen::AngleAxis.new(0.5, Eigen::Vector3.new(0, 1, 0))
+        def aa._dump(_level)
+            Marshal.dump(to_a)
+        end
+        assert_approx_equal Eigen::AngleAxis.new(0.5, Eigen::Vector3.new(0, 1, 0)),
+                            Marshal.load(Marshal.dump(aa))
+    end
+
+    def test_binary_round_trip
+        aa = Eigen::AngleAxis.new(0.5, Eigen::Vector3.new(0, 1, 0))
+        assert_approx_equal aa, Eigen::AngleAxis.from_binary(aa.to_binary)
+    end
+
     def test_dup
         aa = Eigen::AngleAxis.new(0, Eigen::Vector3.new(0, 0, 0))
         assert_approx_equal aa.dup, aa, 0.0001
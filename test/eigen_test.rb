@@ -0,0 +1,37 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigen < Minitest::Test
+    def setup
+        @threads = Eigen.threads
+    end
+
+    def teardown
+        Eigen.threads = @threads
+    end
+
+    def test_threads
+        assert_operator Eigen.threads, :>=, 1
+        Eigen.threads = 2
+        assert_equal 2, Eigen.threads
+    end
+
+    def test_threads_raises_on_invalid_counts
+        assert_raises(ArgumentError) { Eigen.threads = 0 }
+    end
+
+    def test_openmp_p
+        Eigen.threads = 2
+        # Eigen ignores its thread count without OpenMP
+        assert_equal (Eigen.openmp? ? 2 : 1), Eigen.__eigen_threads__
+    end
+
+    def test_aligned_p
+        if Eigen.aligned?
+            assert_operator Eigen.__fixed_alignment__, :>=, 16
+        else
+            assert_equal 8, Eigen.__fixed_alignment__
+        end
+    end
+end
@@ -0,0 +1,74 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigenLazyExpression < Minitest::Test
+    def setup
+        @a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        @b = Eigen::MatrixX.from_a([10, 20, 30, 40], 2, 2)
+        @c = Eigen::MatrixX.from_a([1, 1, 1, 1], 2, 2)
+    end
+
+    def test_eval_matches_eager_arithmetic
+        expected = @a * 2 + @b - @c
+        assert_approx_equal expected, (@a.lazy * 2 + @b - @c).eval
+    end
+
+    def test_scalar_on_the_left
+        assert_approx_equal @a * 3, (3 * @a.lazy).eval
+    end
+
+    def test_division_and_negation
+        assert_approx_equal @a * -0.5, (-@a.lazy / 2).eval
+    end
+
+    def test_merges_terms_on_the_same_operand
+        expr = @a.lazy + @b + @a
+        assert_equal 2, expr.terms.size
+        assert_approx_equal @a * 2 + @b, expr.eval
+    end
+
+    def test_many_terms
+        ops = (1..8).map { |i| Eigen::MatrixX.from_a([i, i, i, i], 2, 2) }
+        expr = ops[1..-1].inject(ops[0].lazy) { |e, m| e + m }
+        assert_equal [36, 36, 36, 36], expr.eval.to_a
+    end
+
+    def test_assign_to_an_operand
+        (@a.lazy * 2 + @b).assign_to(@a)
+        assert_equal [12, 24, 36, 48], @a.to_a
+    end
+
+    def test_assign_to_an_operand_of_a_long_sum
+        ops = (1..5).map { |i| Eigen::MatrixX.from_a([i, i, i, i], 2, 2) }
+        expr = ops[1..-1].inject(ops[0].lazy) { |e, m| e + m }
+        expr.assign_to(ops[4])
+        assert_equal [15, 15, 15, 15], ops[4].to_a
+    end
+
+    def test_assign_to_an_operand_repeated_beyond_the_first_pass
+        @a.__assign_linear__([1, 1, 1, 1, 1, 1], [@b, @a, @a, @a, @a, @a])
+        assert_equal [15, 30, 45, 60], @a.to_a
+    end
+
+    def test_assign_to_resizes_the_output
+        out = Eigen::MatrixX.new(1, 1)
+        (@a.lazy + @b).assign_to(out)
+        assert_equal [2, 2], [out.rows, out.cols]
+    end
+
+    def test_vectors
+        a = Eigen::VectorX.from_a([1, 2, 3])
+        b = Eigen::VectorX.from_a([3, 2, 1])
+        assert_equal [-1, 2, 5], (a.lazy * 2 - b).eval.to_a
+    end
+
+    def test_raises_on_size_mismatch
+        other = Eigen::MatrixX.new(3, 3)
+        assert_raises(ArgumentError) { (@a.lazy + other).eval }
+    end
+
+    def test_raises_on_multiplication_by_a_matrix
+        assert_raises(ArgumentError) { @a.lazy * @b }
+    end
+end
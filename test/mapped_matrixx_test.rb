@@ -0,0 +1,73 @@
+# frozen_string_literal: true
+
+require "test_helper"
+require "fileutils"
+require "tmpdir"
+
+class TCEigenMappedMatrixX < Minitest::Test
+    def setup
+        @dir = Dir.mktmpdir
+        @path = File.join(@dir, "matrix.bin")
+        File.binwrite(@path, [1, 2, 3, 4, 5, 6].pack("d*"))
+    end
+
+    def teardown
+        FileUtils.rm_rf(@dir)
+    end
+
+    def test_read_only_mapping
+        m = Eigen::MatrixX.mmap(@path, 2, 3)
+        assert_equal 2, m.rows
+        assert_equal 3, m.cols
+        refute m.writable?
+        assert_equal 3, m[0, 1]
+        assert_equal Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 2, 3), m.to_matrix
+    end
+
+    def test_operations_match_the_loaded_matrix
+        m = Eigen::MatrixX.mmap(@path, 2, 3)
+        dense = m.to_matrix
+        v = Eigen::VectorX.from_a([1, 0, -1])
+        assert_equal dense.norm, m.norm
+        assert_equal dense.dotV(v), m.dotV(v)
+        assert_equal dense.T, m.T
+        assert_equal dense.dotM(dense.T), m.dotM(dense.T)
+        assert_approx_equal dense.jacobiSvd.singular_values,
+                            m.jacobiSvd.singular_values
+    end
+
+    def test_writes_raise_in_read_only_mode
+        m = Eigen::MatrixX.mmap(@path, 2, 3)
+        assert_raises(IOError) { m[0, 0] = 10 }
+    end
+
+    def test_writes_go_to_the_file_in_read_write_mode
+        m = Eigen::MatrixX.mmap(@path, 2, 3, "r+")
+        m[1, 2] = 10
+        m.sync
+        assert_equal [1, 2, 3, 4, 5, 10], File.binread(@path).unpack("d*")
+    end
+
+    def test_create_mode_sizes_the_file
+        path = File.join(@dir, "new.bin")
+        m = Eigen::MatrixX.mmap(path, 2, 2, "w+")
+        m.replace(Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2))
+        m.close
+        assert_equal [1, 2, 3, 4], File.binread(path).unpack("d*")
+    end
+
+    def test_raises_if_the_file_is_too_small
+        assert_raises(ArgumentError) { Eigen::MatrixX.mmap(@path, 3, 3) }
+    end
+
+    def test_raises_on_invalid_mode
+        assert_raises(ArgumentError) { Eigen::MatrixX.mmap(@path, 2, 3, "a") }
+    end
+
+    def test_raises_after_close
+        m = Eigen::MatrixX.mmap(@path, 2, 3)
+        m.close
+        refute m.mapped?
+        assert_raises(IOError) { m.norm }
+    end
+end
@@ -75,6 +75,25 @@ module Eigen
                 end
             end
         end
+        describe "in-place arithmetic" do
+            before do
+                matrix.from_a((1..16).to_a)
+            end
+            it "adds, subtracts and scales self" do
+                other = Matrix4.from_a([1] * 16)
+                matrix.add!(other)
+                assert_equal (2..17).to_a, matrix.to_a
+                matrix.sub!(other)
+                matrix.scale!(2)
+                assert_equal (1..16).map { |i| i * 2 }, matrix.to_a
+            end
+            it "stores the product of two matrices" do
+                other = Matrix4.from_a((16..31).to_a)
+                result = Matrix4.new
+                result.mul_into!(matrix, other)
+                assert_equal matrix.dotM(other), result
+            end
+        end
         describe "marshalling and demarshalling" do
             before do
                 matrix.from_a((1..16).to_a)
@@ -88,6 +107,15 @@ module Eigen
                 unmarshalled = Marshal.load(marshalled)
                 assert_equal (1..16).to_a, unmarshalled.to_a
             end
+            it "can unmarshal a value that had been marshalled " \
+               "as a packed array" do
+                def matrix._dump(_level)
+                    to_a.pack("E*")
+                end
+                marshalled = Marshal.dump(matrix)
+                unmarshalled = Marshal.load(marshalled)
+                assert_equal (1..16).to_a, unmarshalled.to_a
+            end
             it "can marshal/unmarshal with the new method" do
                 marshalled = Marshal.dump(matrix)
                 unmarshalled = Marshal.load(marshalled)
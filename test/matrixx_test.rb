@@ -89,6 +89,60 @@ class TCEigenMatrixX < Minitest::Test
         assert_equal(m[1, 1], 3)
     end
 
+    def test_from_a_infers_missing_dimension
+        m = Eigen::MatrixX.new
+        m.from_a([0, 1, 2, 3, 4, 5], 3)
+        assert_equal 3, m.rows
+        assert_equal 2, m.cols
+        m.from_a([0, 1, 2, 3, 4, 5], -1, 6)
+        assert_equal 1, m.rows
+        assert_equal 6, m.cols
+    end
+
+    def test_from_a_completes_with_zeroes
+        m = Eigen::MatrixX.new(2, 2)
+        m.from_a([1, nil, 2], 2, 2)
+        assert_equal [1, 0, 2, 0], m.to_a
+    end
+
+    def test_from_a_raises_if_the_array_is_too_big
+        m = Eigen::MatrixX.new(2, 2)
+        assert_raises(ArgumentError) { m.from_a([1, 2, 3, 4, 5], 2, 2) }
+    end
+
+    def test_from_a_raises_on_non_numeric_values
+        m = Eigen::MatrixX.new(2, 2)
+        assert_raises(TypeError) { m.from_a([1, "2", 3, 4], 2, 2) }
+    end
+
+    def test_from_a_handles_arrays_shrunk_by_the_conversion
+        array = [1, 2, 3]
+        shrinking = Object.new
+        shrinking.define_singleton_method(:to_f) do
+            array.clear
+            4.0
+        end
+        array[0] = shrinking
+        m = Eigen::MatrixX.from_a(array, 3, 1)
+        assert_equal [4, 0, 0], m.to_a
+    end
+
+    def test_vector_from_a_raises_on_nil
+        assert_raises(TypeError) { Eigen::VectorX.from_a([1, nil]) }
+    end
+
+    def test_to_a_row_major
+        m = Eigen::MatrixX.from_a([0, 1, 2, 3, 4, 5], 2, 3)
+        assert_equal [0, 2, 4, 1, 3, 5], m.to_a(false)
+    end
+
+    def test_vector_from_a_to_a
+        v = Eigen::VectorX.new
+        v.from_a([1, 2.5, 3])
+        assert_equal 3, v.size
+        assert_equal [1, 2.5, 3], v.to_a
+    end
+
     def test_matrix_dump_load
         m = Eigen::MatrixX.new(9, 7)
         l = 9 * 7
@@ -100,6 +154,50 @@ class TCEigenMatrixX < Minitest::Test
         assert_equal m, loaded
     end
 
+    def test_binary_round_trip
+        m = Eigen::MatrixX.from_a((0...12).to_a, 3, 4)
+        buffer = m.to_binary
+        assert_equal Encoding::BINARY, buffer.encoding
+        assert_equal 16 + 12 * 8, buffer.size
+        assert_equal m, Eigen::MatrixX.from_binary(buffer)
+    end
+
+    def test_from_binary_swaps_foreign_byte_order
+        little = ["EIGl", 1, 8, 2, 1].pack("a4S<2L<2") + [1.5, -2].pack("E*")
+        big = ["EIGb", 1, 8, 2, 1].pack("a4S>2L>2") + [1.5, -2].pack("G*")
+        assert_equal [1.5, -2], Eigen::MatrixX.from_binary(little).to_a
+        assert_equal [1.5, -2], Eigen::MatrixX.from_binary(big).to_a
+        assert_equal [1.5, -2], Eigen::VectorX.from_binary(big).to_a
+    end
+
+    def test_from_binary_raises_on_invalid_buffers
+        buffer = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2).to_binary
+        assert_raises(ArgumentError) { Eigen::MatrixX.from_binary(buffer[0..-2]) }
+        assert_raises(ArgumentError) { Eigen::MatrixX.from_binary("x" * 48) }
+        assert_raises(ArgumentError) { Eigen::VectorX.from_binary(buffer) }
+        future = buffer.dup
+        future[4, 2] = [2].pack("S")
+        assert_raises(ArgumentError) { Eigen::MatrixX.from_binary(future) }
+    end
+
+    def test_marshal_loads_the_legacy_format
+        m = Eigen::MatrixX.from_a((0...6).to_a, 2, 3)
+        def m._dump(_level)
+            Marshal.dump({ "rows" => rows, "cols" => cols, "data" => to_a })
+        end
+        loaded = Marshal.load(Marshal.dump(m))
+        assert_equal 2, loaded.rows
+        assert_equal (0...6).to_a, loaded.to_a
+    end
+
+    def test_vector_marshal_loads_the_legacy_format
+        v = Eigen::VectorX.from_a([1, 2, 3])
+        def v._dump(_level)
+            Marshal.dump(to_a)
+        end
+        assert_equal [1, 2, 3], Marshal.load(Marshal.dump(v)).to_a
+    end
+
     def test_dup
         m = Eigen::MatrixX.new(9, 7)
         l = 9 * 7
@@ -119,6 +217,82 @@ class TCEigenMatrixX < Minitest::Test
         assert_approx_equal expected, b
     end
 
+    def test_in_place_arithmetic
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        m.add!(Eigen::MatrixX.from_a([1, 1, 1, 1], 2, 2))
+        assert_equal [2, 3, 4, 5], m.to_a
+        m.sub!(Eigen::MatrixX.from_a([2, 2, 2, 2], 2, 2))
+        assert_equal [0, 1, 2, 3], m.to_a
+        m.scale!(2)
+        assert_equal [0, 2, 4, 6], m.to_a
+        assert_raises(ArgumentError) { m.add!(Eigen::MatrixX.new(3, 2)) }
+    end
+
+    def test_mul_into
+        a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        b = Eigen::MatrixX.from_a([5, 6, 7, 8], 2, 2)
+        c = Eigen::MatrixX.new
+        c.mul_into!(a, b)
+        assert_equal a.dotM(b), c
+
+        c.mul_into!(a, b, 2, 1)
+        assert_equal a.dotM(b) * 3, c
+    end
+
+    def test_mul_into_handles_aliasing
+        a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        expected = a.dotM(a) * 2 + a
+        a.mul_into!(a, a, 2, 1)
+        assert_equal expected, a
+    end
+
+    def test_mul_into_handles_non_square_aliasing
+        c = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 3, 2)
+        b = Eigen::MatrixX.from_a((1..8).to_a, 2, 4)
+        expected = c.dotM(b)
+        c.mul_into!(c, b)
+        assert_equal expected, c
+
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 3, 2)
+        v = Eigen::VectorX.from_a([1, 1])
+        v.mul_into!(m, v)
+        assert_equal [5, 7, 9], v.to_a
+    end
+
+    def test_mul_into_raises_on_size_mismatch
+        c = Eigen::MatrixX.new(2, 2)
+        assert_raises(ArgumentError) do
+            c.mul_into!(Eigen::MatrixX.new(2, 3), Eigen::MatrixX.new(2, 3))
+        end
+        assert_raises(ArgumentError) do
+            c.mul_into!(Eigen::MatrixX.new(3, 3), Eigen::MatrixX.new(3, 3), 1, 1)
+        end
+    end
+
+    def test_vector_mul_into
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        x = Eigen::VectorX.from_a([1, 1])
+        acc = Eigen::VectorX.from_a([1, 1])
+        acc.mul_into!(m, x, 1, 1)
+        assert_equal [5, 7], acc.to_a
+        acc.mul_into!(m, acc)
+        assert_equal [26, 38], acc.to_a
+    end
+
+    def test_large_products_from_multiple_threads
+        a = Eigen::MatrixX.from_a((0...10_000).map { |i| (i % 17) - 8 }, 100, 100)
+        b = a.T
+        expected = a.dotM(b).to_a
+        threads = (0...4).map { Thread.new { a.dotM(b) } }
+        threads.each { |t| assert_equal expected, t.value.to_a }
+    end
+
+    def test_product_raises_on_size_mismatch
+        m = Eigen::MatrixX.new(2, 3)
+        assert_raises(ArgumentError) { m.dotM(Eigen::MatrixX.new(2, 3)) }
+        assert_raises(ArgumentError) { m.dotV(Eigen::VectorX.new(2)) }
+    end
+
     def test_jacobisvd
         m = Eigen::MatrixX.Zero(7, 7)
         7.times { |i| m[i, i] = 1 }
@@ -128,4 +302,383 @@ class TCEigenMatrixX < Minitest::Test
 
         assert_approx_equal m.dotV(a), b
     end
+
+    def test_svd_solve_raises_without_u_and_v
+        m = Eigen::MatrixX.Identity(3)
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        assert_raises(RuntimeError) { m.jacobiSvd.solve(b) }
+        assert_raises(RuntimeError) { m.bdcSvd.solve(b) }
+        assert_raises(RuntimeError) { m.svd(Eigen::ComputeThinU).solve(b) }
+    end
+
+    def test_svd_rejects_full_and_thin_on_the_same_side
+        m = Eigen::MatrixX.Identity(3)
+        assert_raises(ArgumentError) do
+            m.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeThinU)
+        end
+        assert_raises(ArgumentError) do
+            m.bdcSvd(Eigen::ComputeFullV | Eigen::ComputeThinV)
+        end
+    end
+
+    def spd_matrix
+        Eigen::MatrixX.from_a([4, 1, 0, 1, 3, 1, 0, 1, 2], 3, 3)
+    end
+
+    def test_llt_solves_vectors_and_matrices
+        m = spd_matrix
+        llt = m.llt
+        assert llt.success?
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        assert_approx_equal m.dotV(llt.solve(b)), b
+        rhs = Eigen::MatrixX.from_a([1, 3, 5, 2, 4, 6], 3, 2)
+        assert_approx_equal m.dotM(llt.solve(rhs)), rhs
+        assert_in_delta 18, llt.determinant, 1e-9
+    end
+
+    def test_llt_reports_non_positive_definite_matrices
+        m = Eigen::MatrixX.from_a([1, 2, 2, 1], 2, 2)
+        refute m.llt.success?
+    end
+
+    def test_ldlt
+        m = spd_matrix
+        ldlt = m.ldlt
+        assert ldlt.success?
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        assert_approx_equal m.dotV(ldlt.solve(b)), b
+        assert_in_delta 18, ldlt.determinant, 1e-9
+    end
+
+    def test_lu
+        m = Eigen::MatrixX.from_a([0, 2, 1, 1, 1, 0, 3, 0, 1], 3, 3, false)
+        lu = m.lu
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        assert_approx_equal m.dotV(lu.solve(b)), b
+        assert_in_delta(-5, lu.determinant, 1e-9)
+        assert_operator lu.rcond, :>, 0
+    end
+
+    def test_qr_handles_rectangular_and_rank_deficient_matrices
+        m = Eigen::MatrixX.from_a([1, 2, 3, 2, 4, 6], 3, 2)
+        qr = m.qr
+        assert_equal 1, qr.rank
+        assert_equal 2, qr.solve(Eigen::VectorX.from_a([1, 2, 3])).size
+    end
+
+    def test_factorization_can_be_recomputed
+        lu = Eigen::PartialPivLU.new
+        assert_raises(RuntimeError) { lu.determinant }
+        lu.compute(spd_matrix)
+        assert_in_delta 18, lu.determinant, 1e-9
+        lu.compute(Eigen::MatrixX.from_a([2, 0, 0, 3], 2, 2))
+        assert_in_delta 6, lu.determinant, 1e-9
+    end
+
+    def test_factorization_raises_on_size_mismatch
+        assert_raises(ArgumentError) { Eigen::MatrixX.new(2, 3).llt }
+        lu = spd_matrix.lu
+        assert_raises(ArgumentError) { lu.solve(Eigen::VectorX.new(2)) }
+        assert_raises(ArgumentError) { lu.solve(Eigen::MatrixX.new(2, 2)) }
+    end
+
+    def test_svd_accessors
+        m = Eigen::MatrixX.from_a([3, 0, 0, 0, 2, 0], 3, 2)
+        svd = m.svd
+        assert_kind_of Eigen::JacobiSVD, svd
+        assert_approx_equal Eigen::VectorX.from_a([3, 2]), svd.singular_values
+        assert_equal 2, svd.rank
+        assert_equal 3, svd.matrix_u.rows
+        assert_equal 2, svd.matrix_v.rows
+
+        svd.threshold = 0.9
+        assert_equal 1, svd.rank
+    end
+
+    def test_svd_raises_if_u_was_not_computed
+        svd = Eigen::MatrixX.Zero(3, 3).svd(Eigen::ComputeThinV)
+        assert_raises(RuntimeError) { svd.matrix_u }
+    end
+
+    def test_svd_picks_bdcsvd_for_large_matrices
+        m = Eigen::MatrixX.Zero(20, 20)
+        20.times { |i| m[i, i] = i + 1 }
+        svd = m.svd
+        assert_kind_of Eigen::BDCSVD, svd
+        assert_in_delta 20, svd.singular_values[0], 1e-9
+
+        b = Eigen::VectorX.from_a((1..20).to_a)
+        assert_approx_equal m.dotV(svd.solve(b)), b
+        assert_kind_of Eigen::JacobiSVD, m.svd(algorithm: :jacobi)
+        assert_raises(ArgumentError) { m.svd(algorithm: :qr) }
+    end
+
+    def test_svd_solves_several_right_hand_sides_at_once
+        m = spd_matrix
+        rhs = Eigen::MatrixX.from_a([1, 3, 5, 2, 4, 6], 3, 2)
+        x = m.svd.solve(rhs)
+        assert_kind_of Eigen::MatrixX, x
+        assert_approx_equal m.dotM(x), rhs
+    end
+
+    def test_solve_writes_into_the_output_object
+        m = spd_matrix
+        rhs = Eigen::MatrixX.from_a([1, 3, 5, 2, 4, 6], 3, 2)
+        out = Eigen::MatrixX.new
+        assert_same out, m.llt.solve(rhs, out)
+        assert_approx_equal m.dotM(out), rhs
+
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        out = Eigen::VectorX.new
+        assert_same out, m.svd.solve(b, out)
+        assert_approx_equal m.dotV(out), b
+    end
+
+    def test_solve_output_may_be_the_right_hand_side
+        m = spd_matrix
+        rhs = Eigen::MatrixX.from_a([1, 3, 5, 2, 4, 6], 3, 2)
+        x = rhs.dup
+        m.lu.solve(x, x)
+        assert_approx_equal m.dotM(x), rhs
+    end
+
+    def test_block_reads_and_writes_the_matrix
+        m = Eigen::MatrixX.from_a((0...12).to_a, 3, 4)
+        b = m.block(1, 1, 2, 2)
+        assert_equal 2, b.rows
+        assert_equal [4, 5, 7, 8], b.to_a
+        b[0, 1] = 42
+        assert_equal 42, m[1, 2]
+        b.scale!(2)
+        assert_equal 10, m[2, 1]
+    end
+
+    def test_block_arithmetic
+        m = Eigen::MatrixX.from_a((0...12).to_a, 3, 4)
+        b = m.block(0, 0, 2, 2)
+        other = Eigen::MatrixX.from_a([1, 1, 1, 1], 2, 2)
+        assert_kind_of Eigen::MatrixX, b + other
+        assert_equal [1, 2, 4, 5], (b + other).to_a
+        assert_equal [0, 2, 6, 8], (b * 2).to_a
+        b.add!(m.block(1, 2, 2, 2))
+        assert_equal [7, 9, 13, 15], b.to_a
+        assert_equal [7, 9, 13, 15], m.block(0, 0, 2, 2).to_matrix.to_a
+    end
+
+    def test_row_and_col_views
+        m = Eigen::MatrixX.from_a((0...6).to_a, 2, 3)
+        r = m.row_view(1)
+        assert_equal [1, 3, 5], r.to_a
+        m.col_view(0).replace(Eigen::MatrixX.from_a([10, 11], 2, 1))
+        assert_equal 10, m[0, 0]
+        assert_equal [11, 3, 5], r.to_a
+        assert_equal [35], r.dotV(Eigen::VectorX.from_a([0, 0, 7])).to_a
+    end
+
+    def test_views_keep_their_parent_alive
+        b = Eigen::MatrixX.from_a((0...4).to_a, 2, 2).block(0, 0, 2, 2)
+        GC.start
+        assert_equal [0, 1, 2, 3], b.to_a
+    end
+
+    def test_view_raises_once_out_of_its_parent_bounds
+        m = Eigen::MatrixX.new(3, 3)
+        assert_raises(IndexError) { m.block(2, 2, 2, 2) }
+        b = m.block(1, 1, 2, 2)
+        m.resize(2, 2)
+        assert_raises(IndexError) { b.to_a }
+    end
+
+    def test_vector_segments
+        v = Eigen::VectorX.from_a([1, 2, 3, 4, 5])
+        assert_equal [2, 3], v.segment(1, 2).to_a
+        assert_equal [1, 2], v.head(2).to_a
+        assert_equal [4, 5], v.tail(2).to_a
+        v.tail(2).add!(v.head(2))
+        assert_equal [1, 2, 3, 5, 7], v.to_a
+        assert_in_delta 2 * 5 + 3 * 7, v.segment(1, 2).dot(v.tail(2)), 1e-9
+        assert_raises(IndexError) { v.segment(4, 2) }
+    end
+
+    def test_vector_reductions
+        v = Eigen::VectorX.from_a([3, -4, 1, 0])
+        assert_in_delta 0, v.sum, 1e-9
+        assert_in_delta 0, v.mean, 1e-9
+        assert_equal(-4, v.min)
+        assert_equal 3, v.max
+        assert_equal 1, v.argmin
+        assert_equal 0, v.argmax
+        assert_in_delta 26, v.squared_norm, 1e-9
+        assert_in_delta 8, v.lp_norm(1), 1e-9
+        assert_in_delta Math.sqrt(26), v.lp_norm(2), 1e-9
+        assert_in_delta (27 + 64 + 1)**(1.0 / 3), v.lp_norm(3), 1e-9
+        assert_in_delta 4, v.lp_norm(Float::INFINITY), 1e-9
+        assert_raises(ArgumentError) { v.lp_norm(0.5) }
+    end
+
+    def test_reductions_of_empty_objects
+        v = Eigen::VectorX.new(0)
+        assert_equal 0, v.sum
+        assert_equal 0, v.lp_norm(3)
+        assert_raises(ArgumentError) { v.mean }
+        assert_raises(ArgumentError) { v.argmax }
+        m = Eigen::MatrixX.new(0, 3)
+        assert_equal 0, m.sum
+        assert_raises(ArgumentError) { m.min }
+        assert_raises(ArgumentError) { m.colwise_max }
+    end
+
+    def test_matrix_reductions
+        m = Eigen::MatrixX.from_a([1, -2, 3, 4, 5, -6], 2, 3)
+        assert_in_delta 5, m.sum, 1e-9
+        assert_in_delta 5.0 / 6, m.mean, 1e-9
+        assert_equal(-6, m.min)
+        assert_equal 5, m.max
+        assert_equal [1, 2], m.argmin
+        assert_equal [0, 2], m.argmax
+        assert_in_delta 91, m.squared_norm, 1e-9
+        assert_in_delta 21, m.lp_norm(1), 1e-9
+        assert_in_delta 6, m.lp_norm(Float::INFINITY), 1e-9
+        assert_in_delta 5, m.trace, 1e-9
+    end
+
+    def test_partial_reductions
+        m = Eigen::MatrixX.from_a([1, -2, 3, 4, 5, -6], 2, 3)
+        assert_equal [-1, 7, -1], m.colwise_sum.to_a
+        assert_equal [-0.5, 3.5, -0.5], m.colwise_mean.to_a
+        assert_equal [-2, 3, -6], m.colwise_min.to_a
+        assert_equal [1, 4, 5], m.colwise_max.to_a
+        assert_equal [9, -4], m.rowwise_sum.to_a
+        assert_equal [3, -4.0 / 3], m.rowwise_mean.to_a
+        assert_equal [1, -6], m.rowwise_min.to_a
+        assert_equal [5, 4], m.rowwise_max.to_a
+        assert_in_delta Math.sqrt(5), m.colwise_norm[0], 1e-9
+        assert_in_delta Math.sqrt(1 + 9 + 25), m.rowwise_norm[0], 1e-9
+    end
+
+    def test_covariance
+        m = Eigen::MatrixX.from_a([1, -1, 0, 0, 0, 0, 2, -2], 4, 2)
+        assert_equal [2.0 / 3, 0, 0, 8.0 / 3], m.covariance.to_a
+        assert_equal m.covariance, m.T.covariance(rowwise: false)
+        assert_raises(ArgumentError) { Eigen::MatrixX.new(1, 3).covariance }
+    end
+
+    def test_principal_components_of_small_dimensions
+        m = Eigen::MatrixX.from_a([1, -1, 0, 0, 0, 0, 2, -2], 4, 2)
+        axes, variances = m.principal_components(2)
+        assert_in_delta 0, axes[0, 0], 1e-9
+        assert_in_delta 1, axes[1, 0].abs, 1e-9
+        assert_in_delta 1, axes[0, 1].abs, 1e-9
+        assert_in_delta 8.0 / 3, variances[0], 1e-9
+        assert_in_delta 2.0 / 3, variances[1], 1e-9
+
+        axes, variances = m.T.principal_components(1, rowwise: false)
+        assert_equal [2, 1], [axes.rows, axes.cols]
+        assert_equal 1, variances.size
+        assert_raises(ArgumentError) { m.principal_components(3) }
+    end
+
+    def test_principal_components_of_large_dimensions
+        m = Eigen::MatrixX.from_a(Array.new(30 * 20) { rand }, 30, 20)
+        axes, variances = m.principal_components(20)
+        assert_in_delta m.covariance.trace, variances.sum, 1e-9
+        assert_equal variances.to_a.sort.reverse, variances.to_a
+        20.times { |i| assert_in_delta 1, axes.colwise_norm[i], 1e-9 }
+
+        axes, variances = m.principal_components(3)
+        assert_equal [20, 3], [axes.rows, axes.cols]
+        assert_equal 3, variances.size
+    end
+
+    def test_cwise_functions
+        v = Eigen::VectorX.from_a([-4, 1, 9])
+        assert_equal [4, 1, 9], v.cwise_abs.to_a
+        assert_equal [2, 1, 3], v.cwise_abs.cwise_sqrt.to_a
+        assert_equal [16, 1, 81], v.cwise_square.to_a
+        assert_equal [-0.25, 1, 1.0 / 9], v.cwise_inverse.to_a
+        assert_in_delta Math.exp(1), v.cwise_exp[1], 1e-9
+        assert_in_delta Math.log(9), v.cwise_log[2], 1e-9
+        assert_equal [-4, 1, 9], v.to_a
+
+        v.cwise_square!
+        assert_equal [16, 1, 81], v.to_a
+        v.cwise_sqrt!
+        assert_equal [4, 1, 9], v.to_a
+    end
+
+    def test_cwise_binary_operations
+        a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        b = Eigen::MatrixX.from_a([2, 2, 2, 8], 2, 2)
+        assert_equal [2, 4, 6, 32], a.cwise_product(b).to_a
+        assert_equal [0.5, 1, 1.5, 0.5], a.cwise_quotient(b).to_a
+        assert_equal [1, 2, 2, 4], a.cwise_min(b).to_a
+        assert_equal [2, 2, 3, 8], a.cwise_max(b).to_a
+        assert_equal [2, 2, 3, 4], a.cwise_max(2).to_a
+        assert_raises(ArgumentError) { a.cwise_product(Eigen::MatrixX.new(3, 2)) }
+
+        a.cwise_product!(a)
+        assert_equal [1, 4, 9, 16], a.to_a
+        a.cwise_quotient!(2)
+        assert_equal [0.5, 2, 4.5, 8], a.to_a
+    end
+
+    def test_cwise_clamp
+        v = Eigen::VectorX.from_a([-2, 0.5, 3])
+        assert_equal [0, 0.5, 1], v.cwise_clamp(0, 1).to_a
+        v.cwise_clamp!(-1, 1)
+        assert_equal [-1, 0.5, 1], v.to_a
+        assert_raises(ArgumentError) { v.cwise_clamp(1, 0) }
+    end
+
+    def test_cwise_select
+        mask = Eigen::VectorX.from_a([1, 0, 1])
+        values = Eigen::VectorX.from_a([4, 5, 6])
+        assert_equal [4, 0, 6], mask.cwise_select(values, 0).to_a
+        assert_equal [-1, 5, -1], mask.cwise_select(-1, values).to_a
+        assert_equal [2, 3, 2], mask.cwise_select(2, 3).to_a
+    end
+
+    def test_constructors
+        assert_equal [1, 0, 0, 0, 1, 0], Eigen::MatrixX.Identity(3, 2).to_a
+        assert_equal [1, 0, 0, 1], Eigen::MatrixX.Identity(2).to_a
+        assert_equal ([2.5] * 6), Eigen::MatrixX.Constant(2, 3, 2.5).to_a
+        r = Eigen::MatrixX.Random(4, 5)
+        assert_equal [4, 5], [r.rows, r.cols]
+        assert r.cwise_abs.max <= 1
+        assert_raises(ArgumentError) { Eigen::MatrixX.Zero(-1, 2) }
+
+        assert_equal [0, 0, 0], Eigen::VectorX.Zero(3).to_a
+        assert_equal [1.5, 1.5], Eigen::VectorX.Constant(2, 1.5).to_a
+        assert_equal 4, Eigen::VectorX.Random(4).size
+        assert_kind_of Eigen::VectorXf, Eigen::VectorXf.Zero(2)
+    end
+
+    def test_hstack
+        a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        v = Eigen::VectorX.from_a([5, 6])
+        m = Eigen::MatrixX.hstack([a, v, a])
+        assert_equal [2, 5], [m.rows, m.cols]
+        assert_equal [1, 2, 3, 4, 5, 6, 1, 2, 3, 4], m.to_a
+        assert_raises(ArgumentError) do
+            Eigen::MatrixX.hstack([a, Eigen::MatrixX.new(3, 1)])
+        end
+        assert_raises(TypeError) { Eigen::MatrixX.hstack([a, 1]) }
+    end
+
+    def test_vstack
+        a = Eigen::MatrixX.from_a([1, 2, 3, 4], 2, 2)
+        m = Eigen::MatrixX.vstack([a, Eigen::MatrixX.Identity(1, 2)])
+        assert_equal [3, 2], [m.rows, m.cols]
+        assert_equal [1, 2, 1, 3, 4, 0], m.to_a
+        assert_raises(ArgumentError) do
+            Eigen::MatrixX.vstack([a, Eigen::VectorX.new(2)])
+        end
+        assert_equal 0, Eigen::MatrixX.vstack([]).size
+    end
+
+    def test_stack_in_place_accepts_self_as_a_block
+        a = Eigen::MatrixX.from_a([1, 2], 1, 2)
+        a.__stack__([a, a], false)
+        assert_equal [1, 1, 2, 2], a.to_a
+    end
 end
@@ -0,0 +1,108 @@
+# frozen_string_literal: true
+
+require "test_helper"
+require "fiddle"
+require "tmpdir"
+
+class TCEigenMemoryView < Minitest::Test
+    def setup
+        skip "the MemoryView API is not available" unless defined?(Fiddle::MemoryView)
+        skip "the extension was built without MemoryView support" unless
+            Eigen::MatrixX.method_defined?(:from_memory_view)
+    end
+
+    def with_view(object)
+        view = Fiddle::MemoryView.new(object)
+        yield(view)
+    ensure
+        view&.release
+    end
+
+    def test_matrix_exports_its_coefficients_in_column_major_order
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 2, 3)
+        with_view(m) do |view|
+            assert_equal "d", view.format
+            assert_equal [2, 3], view.shape
+            assert_equal [8, 16], view.strides
+            refute view.readonly?
+            assert_equal 5, view[0, 2]
+            assert_equal [1, 2, 3, 4, 5, 6], view.to_s.unpack("d*")
+        end
+    end
+
+    def test_single_precision_format
+        v = Eigen::VectorXf.from_a([1, 2])
+        with_view(v) do |view|
+            assert_equal "f", view.format
+            assert_equal [2], view.shape
+        end
+    end
+
+    def test_vector3_array_exports_one_vector_per_row
+        a = Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 2, 3), Eigen::Vector3.new(4, 5, 6)]
+        )
+        with_view(a) do |view|
+            assert_equal [2, 3], view.shape
+            assert_equal [24, 8], view.strides
+            assert_equal 6, view[1, 2]
+        end
+    end
+
+    def test_objects_cannot_be_modified_while_exported
+        m = Eigen::MatrixX.new(2, 2)
+        with_view(m) do
+            assert_raises(RuntimeError) { m.resize(3, 3) }
+        end
+        m.resize(3, 3)
+    end
+
+    def test_read_only_mappings_export_read_only_views
+        Dir.mktmpdir do |dir|
+            path = File.join(dir, "matrix.bin")
+            File.binwrite(path, [1, 2, 3, 4].pack("d*"))
+            m = Eigen::MatrixX.mmap(path, 2, 2)
+            with_view(m) { |view| assert view.readonly? }
+            m.close
+        end
+    end
+
+    def test_import_round_trip
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 2, 3)
+        assert_equal m, Eigen::MatrixX.from_memory_view(m)
+        assert_equal m.to_single, Eigen::MatrixXf.from_memory_view(m)
+    end
+
+    def test_import_converts_precision
+        v = Eigen::VectorXf.from_a([1, 2, 3])
+        assert_equal [1, 2, 3], Eigen::VectorX.from_memory_view(v).to_a
+    end
+
+    def test_import_follows_the_strides
+        a = Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 2, 3), Eigen::Vector3.new(4, 5, 6)]
+        )
+        m = Eigen::MatrixX.from_memory_view(a)
+        assert_equal [2, 3], [m.rows, m.cols]
+        assert_equal [1, 2, 3, 4, 5, 6], m.to_a(false)
+        assert_equal a, Eigen::Vector3Array.from_memory_view(m)
+    end
+
+    def test_vector_import_accepts_a_single_column
+        m = Eigen::MatrixX.from_a([1, 2, 3], 3, 1)
+        assert_equal [1, 2, 3], Eigen::VectorX.from_memory_view(m).to_a
+        assert_raises(ArgumentError) do
+            Eigen::VectorX.from_memory_view(Eigen::MatrixX.new(2, 2))
+        end
+    end
+
+    def test_import_rejects_invalid_shapes_and_formats
+        assert_raises(ArgumentError) do
+            Eigen::Vector3Array.from_memory_view(Eigen::MatrixX.new(2, 2))
+        end
+        assert_raises(ArgumentError) do
+            Eigen::MatrixX.from_memory_view(Fiddle::Pointer["abcd"])
+        end
+        assert_raises(TypeError) { Eigen::MatrixX.from_memory_view(Object.new) }
+    end
+end
@@ -71,6 +71,19 @@ class TCEigenQuaternion < Minitest::Test
         assert_equal q, loaded
     end
 
+    def test_marshal_loads_the_legacy_format
+        q = Eigen::Quaternion.new(0.2, 0.5, 0.1, 0.5)
+        def q._dump(_level)
+            Marshal.dump(to_a)
+        end
+        assert_equal Eigen::Quaternion.new(0.2, 0.5, 0.1, 0.5), Marshal.load(Marshal.dump(q))
+    end
+
+    def test_binary_round_trip
+        q = Eigen::Quaternion.new(0.2, 0.5, 0.1, 0.5)
+        assert_equal q, Eigen::Quaternion.from_binary(q.to_binary)
+    end
+
     def test_to_angle_axis
         axis = (Eigen::Vector3.UnitX * 0.4 + Eigen::Vector3.UnitZ * 0.5).normalize
         angle = 0.5
@@ -0,0 +1,78 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigenSinglePrecision < Minitest::Test
+    def test_vector3f
+        v = Eigen::Vector3f.new(1, 2, 3)
+        assert_equal [0, 0, 0], (v - v).to_a
+        assert_in_delta 14, v.dot(v), 1e-6
+        assert_kind_of Eigen::Vector3f, v.cross(Eigen::Vector3f.UnitX)
+        assert_equal "Vector3f(1.0, 2.0, 3.0)", v.to_s
+    end
+
+    def test_values_are_rounded_to_single_precision
+        v = Eigen::Vector3f.new(0.1, 0, 0)
+        refute_equal 0.1, v.x
+        assert_in_delta 0.1, v.x, 1e-7
+    end
+
+    def test_vector3_conversions
+        v = Eigen::Vector3.new(1, 2, 3)
+        f = v.to_single
+        assert_kind_of Eigen::Vector3f, f
+        assert_equal [1, 2, 3], f.to_a
+        assert_kind_of Eigen::Vector3, f.to_double
+        assert_equal v, f.to_double
+    end
+
+    def test_vectorxf
+        v = Eigen::VectorXf.from_a([1, 2, 3])
+        assert_equal [2, 4, 6], (v * 2).to_a
+        assert_equal [1, 2, 3], v.to_double.to_a
+        assert_equal v, Eigen::VectorX.from_a([1, 2, 3]).to_single
+    end
+
+    def test_matrixxf
+        m = Eigen::MatrixXf.from_a([1, 2, 3, 4], 2, 2)
+        v = Eigen::VectorXf.from_a([1, 1])
+        assert_equal [4, 6], m.dotV(v).to_a
+        assert_equal [7, 10, 15, 22], m.dotM(m).to_a
+        assert_kind_of Eigen::MatrixXf, Eigen::MatrixXf.Zero(2, 3)
+    end
+
+    def test_matrixx_conversions
+        m = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 2, 3)
+        f = m.to_single
+        assert_kind_of Eigen::MatrixXf, f
+        assert_equal 2, f.rows
+        assert_equal 3, f.cols
+        assert_equal m, f.to_double
+    end
+
+    def test_quaternionf
+        q = Eigen::Quaternionf.from_angle_axis(Math::PI / 2, Eigen::Vector3f.UnitZ)
+        v = q * Eigen::Vector3f.UnitX
+        assert_kind_of Eigen::Vector3f, v
+        assert_approx_equal Eigen::Vector3f.UnitY, v
+        assert_kind_of Eigen::Quaternionf, q * q
+
+        angle, axis = q.to_angle_axis
+        assert_in_delta Math::PI / 2, angle, 1e-6
+        assert_kind_of Eigen::Vector3f, axis
+    end
+
+    def test_quaternion_conversions
+        q = Eigen::Quaternion.from_angle_axis(0.5, Eigen::Vector3.UnitX)
+        f = q.to_single
+        assert_kind_of Eigen::Quaternionf, f
+        assert_approx_equal q, f.to_double, 1e-6
+    end
+
+    def test_binary_format_records_the_scalar_size
+        v = Eigen::VectorXf.from_a([1, 2, 3])
+        assert_equal v, Eigen::VectorXf.from_binary(v.to_binary)
+        assert_equal v, Marshal.load(Marshal.dump(v))
+        assert_raises(ArgumentError) { Eigen::VectorX.from_binary(v.to_binary) }
+    end
+end
@@ -0,0 +1,167 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigenSparseMatrix < Minitest::Test
+    # The 1D Laplacian, symmetric positive definite
+    def laplacian(size)
+        rows = []
+        cols = []
+        values = []
+        size.times do |i|
+            rows << i
+            cols << i
+            values << 2
+            next if i == 0
+
+            rows.push(i, i - 1)
+            cols.push(i - 1, i)
+            values.push(-1, -1)
+        end
+        Eigen::SparseMatrix.from_triplets(size, size, rows, cols, values)
+    end
+
+    def test_from_triplets
+        m = Eigen::SparseMatrix.from_triplets(2, 3, [0, 1], [2, 0], [5, 7])
+        assert_equal 2, m.rows
+        assert_equal 3, m.cols
+        assert_equal 2, m.nonzeros
+        assert_equal 5, m[0, 2]
+        assert_equal 0, m[1, 1]
+        assert_equal [0, 7, 0, 0, 5, 0], m.to_dense.to_a
+    end
+
+    def test_from_packed_triplets
+        m = Eigen::SparseMatrix.from_triplets(
+            2, 2, [0, 1].pack("l*"), [0, 1].pack("l*"), [3.0, 4.0].pack("d*")
+        )
+        assert_equal [3, 0, 0, 4], m.to_dense.to_a
+    end
+
+    def test_duplicate_triplets_are_summed
+        m = Eigen::SparseMatrix.from_triplets(1, 1, [0, 0], [0, 0], [1, 2])
+        assert_equal 3, m[0, 0]
+    end
+
+    def test_set_from_triplets_raises_on_out_of_bounds_indices
+        m = Eigen::SparseMatrix.new(2, 2)
+        assert_raises(IndexError) { m.set_from_triplets([2], [0], [1]) }
+    end
+
+    def test_set_from_triplets_raises_on_buffer_size_mismatch
+        m = Eigen::SparseMatrix.new(2, 2)
+        assert_raises(ArgumentError) { m.set_from_triplets([0, 1], [0], [1]) }
+        assert_raises(ArgumentError) do
+            m.set_from_triplets("\0\0\0", [0].pack("l*"), [1.0].pack("d*"))
+        end
+    end
+
+    def test_to_triplets_round_trip
+        m = laplacian(4)
+        assert_equal m, m.dup
+    end
+
+    def test_from_dense
+        dense = Eigen::MatrixX.from_a([1, 0, 0, 2], 2, 2)
+        m = Eigen::SparseMatrix.from_dense(dense)
+        assert_equal 2, m.nonzeros
+        assert_equal dense, m.to_dense
+    end
+
+    def test_products_with_dense_operands
+        m = laplacian(3)
+        v = Eigen::VectorX.from_a([1, 2, 3])
+        assert_equal m.to_dense.dotV(v), m.dotV(v)
+        dense = Eigen::MatrixX.from_a([1, 2, 3, 4, 5, 6], 3, 2)
+        assert_equal m.to_dense.dotM(dense), m.dotM(dense)
+        assert_raises(ArgumentError) { m.dotV(Eigen::VectorX.from_a([1, 2])) }
+    end
+
+    def test_arithmetic
+        m = laplacian(3)
+        assert_approx_equal m * 2, m + m
+        assert_equal 0, (m - m).norm
+        assert_equal m, m.T
+    end
+
+    def test_direct_solvers
+        m = laplacian(5)
+        b = Eigen::VectorX.from_a([1, 2, 3, 4, 5])
+        [Eigen::SimplicialLDLT, Eigen::SparseLU].each do |klass|
+            solver = klass.new
+            solver.compute(m)
+            assert solver.success?
+            assert_approx_equal b, m.dotV(solver.solve(b))
+            assert_in_delta 6, solver.determinant, 1e-9
+        end
+    end
+
+    def test_conjugate_gradient
+        m = laplacian(5)
+        b = Eigen::VectorX.from_a([1, 2, 3, 4, 5])
+        solver = Eigen::ConjugateGradient.new
+        solver.tolerance = 1e-12
+        solver.compute(m)
+        x = solver.solve(b)
+        assert solver.success?
+        assert solver.iterations > 0
+        assert_approx_equal b, m.dotV(x)
+    end
+
+    def test_conjugate_gradient_does_not_depend_on_the_matrix_object
+        b = Eigen::VectorX.from_a([1, 2, 3, 4, 5])
+        solver = Eigen::ConjugateGradient.new
+        solver.compute(laplacian(5) * 2)
+        GC.start
+        x = solver.solve(b)
+        assert_approx_equal b, (laplacian(5) * 2).dotV(x)
+
+        m = laplacian(5)
+        solver.compute(m)
+        m.set_from_triplets([0], [0], [1])
+        assert_approx_equal b, laplacian(5).dotV(solver.solve(b))
+    end
+
+    def test_solve_multiple_right_hand_sides
+        m = laplacian(4)
+        b = Eigen::MatrixX.from_a([1, 2, 3, 4, 4, 3, 2, 1], 4, 2)
+        solver = Eigen::SimplicialLDLT.new
+        solver.compute(m)
+        assert_approx_equal b, m.dotM(solver.solve(b))
+    end
+
+    def test_factorize_reuses_the_symbolic_analysis
+        m = laplacian(4)
+        solver = Eigen::SimplicialLDLT.new
+        solver.analyze_pattern(m)
+        solver.factorize(m * 2)
+        b = Eigen::VectorX.from_a([1, 2, 3, 4])
+        assert_approx_equal b, (m * 2).dotV(solver.solve(b))
+    end
+
+    def test_factorize_raises_without_analysis
+        assert_raises(RuntimeError) { Eigen::SparseLU.new.factorize(laplacian(3)) }
+    end
+
+    def test_factorize_raises_on_pattern_mismatch
+        solver = Eigen::SparseLU.new
+        solver.analyze_pattern(laplacian(3))
+        assert_raises(ArgumentError) { solver.factorize(laplacian(4)) }
+    end
+
+    def test_solve_raises_after_a_failed_factorization
+        m = Eigen::SparseMatrix.from_triplets(3, 3, [0, 1, 2, 0, 1, 2], [0, 0, 0, 1, 1, 1],
+                                              [1, 2, 3, 2, 4, 6])
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        solver = Eigen::SparseLU.new
+        solver.compute(m)
+        refute solver.success?
+        assert_raises(RuntimeError) { solver.solve(b) }
+        assert_raises(RuntimeError) { solver.determinant }
+    end
+
+    def test_solve_raises_before_compute
+        b = Eigen::VectorX.from_a([1, 2, 3])
+        assert_raises(RuntimeError) { Eigen::SimplicialLDLT.new.solve(b) }
+    end
+end
@@ -0,0 +1,76 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigenStats < Minitest::Test
+    def teardown
+        Eigen.stats_enabled = false
+        Eigen::Stats.reset
+    end
+
+    def test_memsize_includes_the_payload
+        small = Eigen::MatrixX.new(2, 2)
+        large = Eigen::MatrixX.new(100, 100)
+        assert_equal 100 * 100 * 8 - 2 * 2 * 8, large.memsize - small.memsize
+        assert_operator Eigen::Vector3.new(1, 2, 3).memsize, :>=, 24
+    end
+
+    def test_objects_reports_live_objects_per_class
+        matrices = Array.new(3) { Eigen::MatrixX.new(10, 10) }
+        stats = Eigen.stats[:objects]["Eigen::MatrixX"]
+        assert_operator stats[:count], :>=, 3
+        assert_operator stats[:bytes], :>=, matrices.sum(&:memsize)
+    end
+
+    def test_calls_are_only_counted_while_enabled
+        m = Eigen::MatrixX.new(2, 2)
+        m.dotM(m)
+        assert_nil Eigen.stats[:calls]["Eigen::MatrixX#dotM"]
+
+        Eigen.stats_enabled = true
+        2.times { m.dotM(m) }
+        Eigen.stats_enabled = false
+        m.dotM(m)
+
+        calls = Eigen.stats[:calls]["Eigen::MatrixX#dotM"]
+        assert_equal 2, calls[:count]
+        assert_operator calls[:time], :>, 0
+    end
+
+    def test_disabling_restores_the_native_methods
+        native = Eigen::MatrixX.instance_method(:dotM)
+        Eigen.stats_enabled = true
+        refute_equal native, Eigen::MatrixX.instance_method(:dotM)
+        Eigen.stats_enabled = false
+        assert_equal native, Eigen::MatrixX.instance_method(:dotM)
+        assert_nil Eigen::MatrixX.instance_method(:dotM).source_location
+    end
+
+    def test_ruby_methods_are_not_instrumented
+        Eigen.stats_enabled = true
+        Eigen::MatrixX.new(2, 2).dup
+        refute Eigen.stats[:calls].key?("Eigen::MatrixX#dup")
+        assert Eigen.stats[:calls].key?("Eigen::MatrixX#initialize")
+    end
+
+    def test_internal_helpers_are_not_instrumented
+        Eigen.stats_enabled = true
+        m = Eigen::MatrixX.new(2, 2)
+        m.dotM(m)
+        assert Eigen.stats[:calls].key?("Eigen::MatrixX#dotM")
+        refute Eigen.stats[:calls].key?("Eigen::MatrixX#__report_memsize__")
+    end
+
+    def test_payloads_are_reported_to_the_gc_while_enabled
+        # Freeing reported objects would change the total
+        GC.disable
+        Eigen.stats_enabled = true
+        before = Eigen.__reported_memsize__
+        m = Eigen::MatrixX.new(100, 100)
+        assert_equal before + 100 * 100 * 8, Eigen.__reported_memsize__
+        m.resize(10, 10)
+        assert_equal before + 10 * 10 * 8, Eigen.__reported_memsize__
+    ensure
+        GC.enable
+    end
+end
@@ -0,0 +1,98 @@
+# frozen_string_literal: true
+
+require "test_helper"
+
+class TCEigenVector3Array < Minitest::Test
+    def make_array
+        Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 2, 3), Eigen::Vector3.new(0, 3, 4)]
+        )
+    end
+
+    def test_base
+        a = Eigen::Vector3Array.new(3)
+        assert_equal 3, a.size
+        assert_equal Eigen::Vector3.Zero, a[2]
+    end
+
+    def test_set_get
+        a = make_array
+        assert_equal Eigen::Vector3.new(1, 2, 3), a[0]
+        assert_equal Eigen::Vector3.new(0, 3, 4), a[1]
+        assert_raises(IndexError) { a[2] }
+        assert_raises(IndexError) { a[-1] = Eigen::Vector3.Zero }
+    end
+
+    def test_resize_keeps_existing_vectors
+        a = make_array
+        a.resize(3)
+        assert_equal Eigen::Vector3.new(0, 3, 4), a[1]
+        assert_equal Eigen::Vector3.Zero, a[2]
+    end
+
+    def test_each
+        assert_equal [[1, 2, 3], [0, 3, 4]], make_array.map(&:to_a)
+    end
+
+    def test_offset_and_scale
+        a = make_array
+        offset = Eigen::Vector3.new(1, 1, 1)
+        assert_equal [[2, 3, 4], [1, 4, 5]], (a + offset).map(&:to_a)
+        assert_equal [[0, 1, 2], [-1, 2, 3]], (a - offset).map(&:to_a)
+        assert_equal [[2, 4, 6], [0, 6, 8]], (a * 2).map(&:to_a)
+
+        a.add!(offset)
+        a.scale!(2)
+        a.sub!(offset)
+        assert_equal [[3, 5, 7], [1, 7, 9]], a.map(&:to_a)
+    end
+
+    def test_norms_and_dot
+        a = make_array
+        assert_approx_equal Eigen::VectorX.from_a([Math.sqrt(14), 5]), a.norms
+        assert_equal [14, 25], a.dot(a).to_a
+        assert_raises(ArgumentError) { a.dot(Eigen::Vector3Array.new(1)) }
+    end
+
+    def test_binary_round_trip
+        a = make_array
+        assert_equal a, Eigen::Vector3Array.from_binary(a.to_binary)
+        assert_equal a, Marshal.load(Marshal.dump(a))
+    end
+
+    def test_from_binary_accepts_3xn_matrices
+        m = Eigen::MatrixX.from_a([1, 2, 3, 0, 3, 4], 3, 2)
+        assert_equal make_array, Eigen::Vector3Array.from_binary(m.to_binary)
+        assert_raises(ArgumentError) do
+            Eigen::Vector3Array.from_binary(Eigen::MatrixX.new(2, 2).to_binary)
+        end
+    end
+
+    def test_mean_and_covariance
+        a = Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 1, 0), Eigen::Vector3.new(3, 1, 0),
+             Eigen::Vector3.new(1, 3, 0), Eigen::Vector3.new(3, 3, 0)]
+        )
+        assert_equal Eigen::Vector3.new(2, 2, 0), a.mean
+        assert_equal [4.0 / 3, 0, 0, 0, 4.0 / 3, 0, 0, 0, 0], a.covariance.to_a
+        assert_raises(ArgumentError) { Eigen::Vector3Array.new.mean }
+        assert_raises(ArgumentError) { Eigen::Vector3Array.new(1).covariance }
+    end
+
+    def test_principal_components_give_the_normal_of_a_planar_set
+        a = Eigen::Vector3Array.from_vectors(
+            [Eigen::Vector3.new(1, 0, 1), Eigen::Vector3.new(0, 1, 1),
+             Eigen::Vector3.new(-1, 0, 1), Eigen::Vector3.new(0, -2, 1)]
+        )
+        axes, variances = a.principal_components
+        assert_in_delta 1, axes[2, 2].abs, 1e-9
+        assert_in_delta 0, variances[2], 1e-9
+        assert variances[0] >= variances[1]
+        assert_raises(ArgumentError) { a.principal_components(4) }
+    end
+
+    def test_negative_sizes_raise
+        assert_raises(ArgumentError) { Eigen::Vector3Array.new(-1) }
+        assert_raises(ArgumentError) { Eigen::Vector3Array.new(2).resize(-1) }
+    end
+end
@@ -37,6 +37,16 @@ class TCEigenVector3 < Minitest::Test
         assert_equal([1, 2, 3], (v0 / 2.0).to_a)
     end
 
+    def test_in_place_arithmetic
+        v = Eigen::Vector3.new(1, 2, 3)
+        v.add!(Eigen::Vector3.new(1, 1, 1))
+        assert_equal [2, 3, 4], v.to_a
+        v.sub!(Eigen::Vector3.new(2, 2, 2))
+        assert_equal [0, 1, 2], v.to_a
+        v.scale!(2)
+        assert_equal [0, 2, 4], v.to_a
+    end
+
     def test_dump_load
         v = Eigen::Vector3.new(0.2, 0.5, 0.1)
         dumped = Marshal.dump(v)
@@ -44,6 +54,24 @@ class TCEigenVector3 < Minitest::Test
         assert_equal v, loaded
     end
 
+    def test_binary_round_trip
+        v = Eigen::Vector3.new(0.2, 0.5, 0.1)
+        assert_equal v, Eigen::Vector3.from_binary(v.to_binary)
+    end
+
+    def test_from_binary_raises_on_size_mismatch
+        buffer = Eigen::VectorX.from_a([1, 2]).to_binary
+        assert_raises(ArgumentError) { Eigen::Vector3.from_binary(buffer) }
+    end
+
+    def test_marshal_loads_the_legacy_format
+        v = Eigen::Vector3.new(0.2, 0.5, 0.1)
+        def v._dump(_level)
+            Marshal.dump(to_a)
+        end
+        assert_equal Eigen::Vector3.new(0.2, 0.5, 0.1), Marshal.load(Marshal.dump(v))
+    end
+
     def test_dup
         v = Eigen::Vector3.new(0.2, 0.5, 0.1)
         new = v.dup